@@ -10,6 +10,18 @@
 #define __HHArray__HHArray__
 
 #include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Error handling depends on how the library is built:
+ * - By default, functions documented to "print an error message and exit"
+ *   print the error and return without touching out-of-bounds memory.
+ * - With `HHARRAY_CHECKED` defined, they print the error and abort.
+ * - With `HHARRAY_UNCHECKED` defined, index checks are compiled out entirely.
+ *   Passing an invalid index is then undefined behavior.
+ * The `hharray_try_*` functions always check, and report errors with an
+ * `HHArrayStatus` instead.
+ */
 
 #ifndef _HHARRAY_DEFINED_
 typedef struct { } *HHArray;
@@ -17,6 +29,24 @@ typedef struct { } *HHArray;
 
 extern const size_t HHArrayNotFound;
 
+/**
+ * Results of the non-fatal `hharray_try_*` functions.
+ */
+typedef enum {
+    HHArrayStatusOK = 0,
+    HHArrayStatusIndexOutOfBounds,
+    HHArrayStatusEmpty
+} HHArrayStatus;
+
+/**
+ * State for HHArray's explicit-state random number generator (xoshiro256++).
+ * Seed it with `hharray_random_seed()` before use.
+ * @note A state is not thread safe; give each thread its own.
+ */
+typedef struct {
+    uint64_t s[4];
+} HHRandom;
+
 /**
  * Initializes an HHArray with a given capacity.
  * If you plan on using the array to store many values,
@@ -44,11 +74,29 @@ HHArray hharray_copy(HHArray array);
  * Inserts the full contents of an array into an existing array at a given index.
  * @param dest the destination which will hold the combined values.
  * @param source the array to insert into `dest`.
- * @param index the index at which to insert the values.
+ * @param index the index at which to insert the values. Passing the size
+ *              of `dest` appends the values.
+ * @note if `index` is greater than the size of `dest`, this function prints an error and exits.
  * @note `O(n)`
  */
 void hharray_insert_list(HHArray dest, HHArray source, size_t index);
 
+/**
+ * Replaces `remove_count` values of `dest`, starting at `index`, with
+ * `source_count` values of `source`, starting at `source_start`.
+ * Grows `dest` at most once, by the usual factor or to the size needed if
+ * that is larger, and shifts its tail with a single `memmove`, however many
+ * values are removed and inserted.
+ * @param source the array to take values from. May be `dest` itself, and
+ *               may be NULL if `source_count` is 0.
+ * @param removed if not NULL, receives a new array holding the removed values.
+ * @note if either range is out of bounds, this function prints an error and exits,
+ *       leaving `dest` unchanged.
+ * @note `O(n)` where n is the number of values after `index`.
+ */
+void hharray_splice(HHArray dest, size_t index, size_t remove_count,
+                    HHArray source, size_t source_start, size_t source_count, HHArray *removed);
+
 /**
  * Searches the array for the provided value by comparing pointers directly.
  * @param array the array to search
@@ -101,6 +149,27 @@ void *hharray_remove_f(HHArray array, void *element, int (*is_equal)(void *, voi
  */
 void hharray_destroy(HHArray array);
 
+/**
+ * Removes every value that is equal to an earlier value in the array,
+ * keeping the first occurrence of each and the order of what remains.
+ * @param hash a hash function for values. Values that are equal must hash equally.
+ * @param is_equal a function used to check equality of two void *'s.
+ * @note if `hash` and `is_equal` are both NULL, values are compared by pointer
+ *       and hashed by their bits, without any function calls.
+ *       Providing only one of them prints an error and exits.
+ * @note `O(n)` expected, using a temporary hash set sized for the array.
+ */
+void hharray_unique(HHArray array, size_t (*hash)(void *), int (*is_equal)(void *, void *));
+
+/**
+ * Counts the distinct values in the array, without modifying it.
+ * @param hash a hash function for values. Values that are equal must hash equally.
+ * @param is_equal a function used to check equality of two void *'s.
+ * @note if `hash` and `is_equal` are both NULL, values are compared by pointer.
+ * @note `O(n)` expected, using a temporary hash set sized for the array.
+ */
+size_t hharray_distinct_count(HHArray array, size_t (*hash)(void *), int (*is_equal)(void *, void *));
+
 /** 
  * A generic map function for entries of the array.
  * Creates a new array containing the result of applying
@@ -140,6 +209,42 @@ HHArray hharray_filter(HHArray array, int (*include)(void *));
  */
 void *hharray_reduce(HHArray array, void *initial, void *(*combine)(void *, void *));
 
+/**
+ * A batched version of `hharray_map()`.
+ * `transform` is called with consecutive blocks of up to 1024 values at a
+ * time, and writes one result per input into `out`, which points directly
+ * into the new array's storage. Cheap transforms avoid a call per value
+ * and can be vectorized.
+ * @param context passed unchanged to every call of `transform`. May be NULL.
+ * @return A new HHArray containing the results, in order.
+ * @note `O(n)`
+ */
+HHArray hharray_map_batch(HHArray array, void (*transform)(void *const *in, void **out, size_t count, void *context),
+                          void *context);
+
+/**
+ * A batched version of `hharray_filter()`.
+ * `include` is called with consecutive blocks of up to 1024 values at a
+ * time, and sets `mask[i]` to non-zero for each value `in[i]` to keep.
+ * @param context passed unchanged to every call of `include`. May be NULL.
+ * @return A new HHArray containing the kept values, in order.
+ * @note `O(n)`
+ */
+HHArray hharray_filter_batch(HHArray array, void (*include)(void *const *in, uint8_t *mask, size_t count, void *context),
+                             void *context);
+
+/**
+ * A batched version of `hharray_reduce()`.
+ * `combine` is called with the current value and consecutive blocks of up
+ * to 1024 values at a time, and returns the new current value.
+ * @param context passed unchanged to every call of `combine`. May be NULL.
+ * @return the final combined value.
+ * @note `O(n)`
+ */
+void *hharray_reduce_batch(HHArray array, void *initial,
+                           void *(*combine)(void *current, void *const *in, size_t count, void *context),
+                           void *context);
+
 /**
  * Returns all the values contained in the array.
  * @param array The array whose elements are to be transformed.
@@ -156,6 +261,12 @@ void **hharray_values(HHArray array);
  */
 size_t hharray_size(HHArray array);
 
+/**
+ * @return the number of items the array can hold before it next grows.
+ * @note `O(1)`
+ */
+size_t hharray_capacity(HHArray array);
+
 /**
  * Appends the `value` at the end of the array's storage.
  * @note `O(1)`
@@ -203,6 +314,45 @@ void *hharray_remove_index(HHArray array, size_t index);
  */
 void *hharray_pop(HHArray array);
 
+/**
+ * Non-fatal version of `hharray_get()`.
+ * @param value receives the value held at `index`, if `index` is valid.
+ * @return `HHArrayStatusIndexOutOfBounds` if `index` is not a valid index,
+ *         without printing anything.
+ * @note `O(1)`
+ */
+HHArrayStatus hharray_try_get(HHArray array, size_t index, void **value);
+
+/**
+ * Non-fatal version of `hharray_insert_index()`.
+ * @return `HHArrayStatusIndexOutOfBounds` if `index` is greater than the
+ *         array's size, without printing anything.
+ */
+HHArrayStatus hharray_try_insert_index(HHArray array, void *value, size_t index);
+
+/**
+ * Non-fatal version of `hharray_remove_index()`.
+ * @param value receives the removed value. May be NULL.
+ * @return `HHArrayStatusIndexOutOfBounds` if `index` is not a valid index,
+ *         without printing anything.
+ */
+HHArrayStatus hharray_try_remove_index(HHArray array, size_t index, void **value);
+
+/**
+ * Non-fatal version of `hharray_swap()`.
+ * @return `HHArrayStatusIndexOutOfBounds` if either index is not a valid index,
+ *         without printing anything.
+ * @note `O(1)`
+ */
+HHArrayStatus hharray_try_swap(HHArray array, size_t first_index, size_t second_index);
+
+/**
+ * Non-fatal version of `hharray_pop()`.
+ * @param value receives the removed value. May be NULL.
+ * @return `HHArrayStatusEmpty` if the array is empty, without printing anything.
+ */
+HHArrayStatus hharray_try_pop(HHArray array, void **value);
+
 /**
  * Inserts the value at the beginning of the list.
  * @note requires a complete `O(n)` swap of each existing
@@ -224,6 +374,66 @@ void hharray_enqueue(HHArray array, void *value);
  */
 void *hharray_dequeue(HHArray array);
 
+/**
+ * Rearranges the array into a priority queue (a 4-ary min-heap), so that
+ * `hharray_heap_peek()` returns the value that sorts first.
+ * @param comparison A comparison function, with the same contract as `hharray_sort()`.
+ *                   To get the largest value first, pass a comparison that sorts descending.
+ * @param moved An optional function called with a value and its new index
+ *              whenever the heap moves a value, so callers can track positions
+ *              for `hharray_heap_decrease_key()`. May be NULL.
+ * @note `O(n)`
+ */
+void hharray_heapify(HHArray array, int (*comparison)(const void *a, const void *b),
+                     void (*moved)(void *value, size_t index));
+
+/**
+ * Adds a value to a heap built with `hharray_heapify()`.
+ * @note `moved` is called for the pushed value with its final index,
+ *       and for every value it displaces. May be NULL.
+ * @note `O(log(n))`
+ */
+void hharray_heap_push(HHArray array, void *value, int (*comparison)(const void *a, const void *b),
+                       void (*moved)(void *value, size_t index));
+
+/**
+ * Removes the value that sorts first from a heap.
+ * @return the removed value.
+ * @note if the heap is empty, this function prints an error and exits.
+ * @note `O(log(n))`
+ */
+void *hharray_heap_pop(HHArray array, int (*comparison)(const void *a, const void *b),
+                       void (*moved)(void *value, size_t index));
+
+/**
+ * @return the value that sorts first in a heap, without removing it.
+ * @note if the heap is empty, this function prints an error and exits.
+ * @note `O(1)`
+ */
+void *hharray_heap_peek(HHArray array);
+
+/**
+ * Replaces the value that sorts first in a heap with `value`.
+ * Cheaper than a pop followed by a push.
+ * @return the replaced value.
+ * @note if the heap is empty, this function prints an error and exits.
+ * @note `O(log(n))`
+ */
+void *hharray_heap_replace(HHArray array, void *value, int (*comparison)(const void *a, const void *b),
+                           void (*moved)(void *value, size_t index));
+
+/**
+ * Replaces the value at `index` in a heap with `value`, which should sort
+ * before the old value, and restores the heap order. If it sorts after
+ * instead, it is moved towards the leaves, so this can also increase a key.
+ * @param index the value's current index, as last reported through `moved`.
+ * @note if `index` is not a valid index, this function prints an error and exits.
+ * @note `O(log(n))`
+ */
+void hharray_heap_decrease_key(HHArray array, size_t index, void *value,
+                               int (*comparison)(const void *a, const void *b),
+                               void (*moved)(void *value, size_t index));
+
 /**
  * Prints the contents of the array using the specified print
  * function on each value.
@@ -249,6 +459,93 @@ void hharray_print(HHArray array);
  */
 void hharray_sort(HHArray array, int (*comparison)(const void *a, const void *b));
 
+/**
+ * Sorts an array using the provided comparison function, keeping values
+ * that compare equal in their original order.
+ * Uses an adaptive merge sort that detects existing ascending and descending
+ * runs, so nearly sorted arrays sort in close to linear time.
+ * @param comparison A comparison function, with the same contract as `hharray_sort()`.
+ * @note `O(n * log(n))` worst case, `O(n)` for already sorted input.
+ *       Allocates a buffer of `n / 2` values.
+ */
+void hharray_sort_stable(HHArray array, int (*comparison)(const void *a, const void *b));
+
+/**
+ * Rearranges the array so that the value at `nth` is the value that would be
+ * there if the array were sorted. Every value before it compares less than
+ * or equal to it, and every value after compares greater than or equal.
+ * @param comparison A comparison function, with the same contract as `hharray_sort()`.
+ * @note if `nth` is not a valid index, this function prints an error and exits.
+ * @note `O(n)` on average, `O(n * log(n))` in worst case (introselect).
+ */
+void hharray_nth_element(HHArray array, size_t nth, int (*comparison)(const void *a, const void *b));
+
+/**
+ * Sorts the `k` smallest values into the first `k` slots of the array.
+ * The order of the remaining values is unspecified.
+ * If `k` is at least the array's size, the whole array is sorted.
+ * @param comparison A comparison function, with the same contract as `hharray_sort()`.
+ * @note `O(n + k * log(k))` on average.
+ */
+void hharray_partial_sort(HHArray array, size_t k, int (*comparison)(const void *a, const void *b));
+
+/**
+ * Returns the `k` smallest values of the array, in sorted order, without
+ * modifying the array. Values that compare equal keep their original order.
+ * To get the `k` largest values, pass a comparison that sorts descending.
+ * @param comparison A comparison function, with the same contract as `hharray_sort()`.
+ * @return a new array of `min(k, n)` values.
+ * @note `O(n * log(k))`, using a bounded heap of `k` values.
+ */
+HHArray hharray_top_k(HHArray array, size_t k, int (*comparison)(const void *a, const void *b));
+
+/**
+ * Merges two sorted arrays into a new sorted array.
+ * Values that compare equal keep their order, with values from `a` first.
+ * @param comparison A comparison function, with the same contract as `hharray_sort()`.
+ * @return a new array holding every value of `a` and `b`.
+ * @note `O(n + m)`, with one allocation for the result.
+ */
+HHArray hharray_merge_sorted(HHArray a, HHArray b, int (*comparison)(const void *a, const void *b));
+
+/**
+ * Merges `count` sorted arrays into a new sorted array, using a heap
+ * over the head of each array.
+ * Values that compare equal keep their order, with values from earlier arrays first.
+ * @param comparison A comparison function, with the same contract as `hharray_sort()`.
+ * @return a new array holding every value of every array.
+ * @note `O(n * log(k))` where n is the total size, with one allocation for the result.
+ */
+HHArray hharray_merge_k(HHArray *arrays, size_t count, int (*comparison)(const void *a, const void *b));
+
+/**
+ * Computes the union of two sorted arrays.
+ * A value that appears `x` times in `a` and `y` times in `b` appears `max(x, y)` times.
+ * Where values compare equal, the value from `a` is kept.
+ * @return a new sorted array.
+ * @note `O(n + m)`, with one allocation sized for the largest possible result.
+ */
+HHArray hharray_union(HHArray a, HHArray b, int (*comparison)(const void *a, const void *b));
+
+/**
+ * Computes the intersection of two sorted arrays.
+ * A value that appears `x` times in `a` and `y` times in `b` appears `min(x, y)` times,
+ * using the values from `a`.
+ * @return a new sorted array.
+ * @note `O(n + m)`, or `O(n * log(m / n))` when one array is much smaller than
+ *       the other, by galloping through the larger one.
+ *       Uses one allocation sized for the largest possible result.
+ */
+HHArray hharray_intersection(HHArray a, HHArray b, int (*comparison)(const void *a, const void *b));
+
+/**
+ * Computes the values of sorted array `a` that are not in sorted array `b`.
+ * A value that appears `x` times in `a` and `y` times in `b` appears `max(x - y, 0)` times.
+ * @return a new sorted array.
+ * @note `O(n + m)`, with one allocation sized for the largest possible result.
+ */
+HHArray hharray_difference(HHArray a, HHArray b, int (*comparison)(const void *a, const void *b));
+
 /**
  * Shuffles the array using a Fischer-Yates shuffle.
  * @pre assumes you have seeded the random number generator with `srand()`.
@@ -256,10 +553,57 @@ void hharray_sort(HHArray array, int (*comparison)(const void *a, const void *b)
  */
 void hharray_shuffle(HHArray array);
 
+/**
+ * Seeds a random number generator state from a single 64-bit value.
+ * The same seed always produces the same sequence.
+ * @note `O(1)`
+ */
+void hharray_random_seed(HHRandom *rng, uint64_t seed);
+
+/**
+ * @return the next 64 random bits from `rng`.
+ * @note `O(1)`
+ */
+uint64_t hharray_random_next(HHRandom *rng);
+
+/**
+ * @return a uniformly distributed random number in `[0, bound)`,
+ *         without modulo bias. Returns 0 if `bound` is 0.
+ * @note `O(1)` expected.
+ */
+uint64_t hharray_random_bounded(HHRandom *rng, uint64_t bound);
+
+/**
+ * Shuffles the array using a Fischer-Yates shuffle driven by `rng`.
+ * Every permutation is equally likely, and the result is reproducible
+ * for a given seed.
+ * @note `O(n)`
+ */
+void hharray_shuffle_r(HHArray array, HHRandom *rng);
+
+/**
+ * Shuffles the array using up to `threads` threads.
+ * Each thread shuffles one block of the array, then neighbouring blocks
+ * are merged in parallel with a random merge (MergeShuffle), which keeps
+ * every permutation equally likely.
+ * Small arrays are shuffled with `hharray_shuffle_r()` on the calling thread.
+ * @note `O(n * log(threads))` total work.
+ */
+void hharray_shuffle_parallel(HHArray array, HHRandom *rng, size_t threads);
+
+/**
+ * Draws `k` distinct elements from the array, uniformly at random,
+ * without modifying the array.
+ * @return a new array with `k` elements in random order.
+ * @note if `k` is greater than the array's size, this function prints an error and exits.
+ * @note `O(k)` time and space, using Floyd's sampling algorithm.
+ */
+HHArray hharray_sample(HHArray array, size_t k, HHRandom *rng);
+
 /**
  * Returns a portion of the array's contents, from `start` to `end`, exclusive.
  * @return a new array with the contents of `array` from `start` to `end`.
- * @note if `start` or `end` are invalid indices, this function prints an error and exits.
+ * @note if `start` or `end` are greater than the array's size, this function prints an error and exits.
  * @note if `start > end`, the slice will come back as if walked in reverse-order.
  * @note `O(n)` where `n` is `abs(end - start)`
  */
@@ -267,10 +611,38 @@ HHArray hharray_slice(HHArray array, size_t start, size_t end);
 
 /**
  * Reverses an array in-place.
- * @note `O(n/2)`
+ * @note `O(n/2)`, moving four values at a time when AVX2 is available.
  */
 void hharray_reverse(HHArray array);
 
+/**
+ * Rotates an array in-place to the left by `k` positions, so the value
+ * at index `k` becomes the first value. `k` is taken modulo the array's size;
+ * to rotate right by `k`, pass `hharray_size(array) - k`.
+ * @note `O(n)`, using three reversals.
+ */
+void hharray_rotate(HHArray array, size_t k);
+
+/**
+ * Reorders an array in-place so that the value at index `i` becomes
+ * the value previously at `permutation[i]`. This applies the output of an
+ * argsort on another array directly.
+ * @param permutation `hharray_size(array)` indices, each used exactly once.
+ * @note if any index in `permutation` is out of bounds, this function prints an
+ *       error and exits, leaving the array unchanged.
+ * @note `O(n)`, in one pass into a new buffer, prefetching ahead.
+ */
+void hharray_permute(HHArray array, const size_t *permutation);
+
+/**
+ * Collects the values at the given indices into a new array.
+ * @param indices `count` indices into `array`. Indices may repeat.
+ * @return a new array whose value at `i` is the value of `array` at `indices[i]`.
+ * @note if any index is out of bounds, this function prints an error and exits.
+ * @note `O(k)`, prefetching ahead.
+ */
+HHArray hharray_gather(HHArray array, const size_t *indices, size_t count);
+
 /**
  * @return `true` if the array is sorted as per the comparison function.
  * @note `O(n)`, but short circuits on finding an unsorted pair.
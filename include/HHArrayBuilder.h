@@ -0,0 +1,69 @@
+//
+//  HHArrayBuilder.h
+//  HHArray
+//
+//  Builds one HHArray from many threads. Each thread appends to its own
+//  local buffer without any synchronization, and finishing the builder
+//  copies every buffer into a single exactly-sized allocation in parallel.
+//
+
+#ifndef __HHArray__HHArrayBuilder__
+#define __HHArray__HHArrayBuilder__
+
+#include <stdio.h>
+#include "HHArray.h"
+
+#ifndef _HHARRAYBUILDER_DEFINED_
+typedef struct { } *HHArrayBuilder;
+typedef struct { } *HHArrayBuilderLocal;
+#endif
+
+/**
+ * Creates a builder with one local buffer per thread.
+ * @param thread_count the number of threads that will append values.
+ * @note if `thread_count` is 0, this function prints an error and exits.
+ * @note `O(thread_count)`
+ */
+HHArrayBuilder hharray_builder_create(size_t thread_count);
+
+/**
+ * @return the local buffer for the thread numbered `thread_index`.
+ *         Each local buffer must only be used by one thread at a time.
+ * @note if `thread_index` is not below the builder's thread count,
+ *       this function prints an error and exits.
+ * @note `O(1)`
+ */
+HHArrayBuilderLocal hharray_builder_local(HHArrayBuilder builder, size_t thread_index);
+
+/**
+ * Appends a value to a thread's local buffer.
+ * The buffer grows in chunks, so existing values are never copied.
+ * @note `O(1)`
+ */
+void hharray_builder_append(HHArrayBuilderLocal local, void *value);
+
+/**
+ * @return the number of values appended to a local buffer so far.
+ * @note `O(1)`
+ */
+size_t hharray_builder_local_size(HHArrayBuilderLocal local);
+
+/**
+ * Combines every local buffer into one new HHArray and frees the builder.
+ * The result holds thread 0's values in the order they were appended,
+ * followed by thread 1's, and so on.
+ * @param threads the number of threads to copy with. The total size is
+ *                computed first, the result is allocated once, and each
+ *                thread copies an equal share of it.
+ * @pre no thread is still appending.
+ * @note `O(n / threads)`
+ */
+HHArray hharray_builder_finish(HHArrayBuilder builder, size_t threads);
+
+/**
+ * Frees a builder and its local buffers without building an array.
+ * @note This does not free any of the values appended to the builder.
+ */
+void hharray_builder_destroy(HHArrayBuilder builder);
+
+#endif /* defined(__HHArray__HHArrayBuilder__) */
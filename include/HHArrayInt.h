@@ -0,0 +1,72 @@
+//
+//  HHArrayInt.h
+//  HHArray
+//
+//  Aggregates over HHArrays whose slots hold integers rather than pointers,
+//  i.e. arrays filled with `hharray_append(array, (void *)(long)value)`.
+//
+
+#ifndef __HHArray__HHArrayInt__
+#define __HHArray__HHArrayInt__
+
+#include <stdint.h>
+#include "HHArray.h"
+
+/**
+ * Sums the integers stored in the array's slots.
+ * @return the sum, wrapping on overflow. 0 for an empty array.
+ * @note `O(n)`, vectorized with AVX2 when available.
+ */
+int64_t hharray_i64_sum(HHArray array);
+
+/**
+ * @return the smallest integer stored in the array,
+ *         or `INT64_MAX` if the array is empty.
+ * @note `O(n)`, vectorized with AVX2 when available.
+ */
+int64_t hharray_i64_min(HHArray array);
+
+/**
+ * @return the largest integer stored in the array,
+ *         or `INT64_MIN` if the array is empty.
+ * @note `O(n)`, vectorized with AVX2 when available.
+ */
+int64_t hharray_i64_max(HHArray array);
+
+/**
+ * Finds the smallest and largest integers in the array in a single pass.
+ * @param min_out receives the minimum, or `INT64_MAX` if the array is empty.
+ * @param max_out receives the maximum, or `INT64_MIN` if the array is empty.
+ * @note `O(n)`, vectorized with AVX2 when available.
+ */
+void hharray_i64_minmax(HHArray array, int64_t *min_out, int64_t *max_out);
+
+/**
+ * Counts the integers in the array that fall within `[low, high)`.
+ * @note `O(n)`, vectorized with AVX2 when available.
+ */
+size_t hharray_i64_count_if_range(HHArray array, int64_t low, int64_t high);
+
+/**
+ * Counts the integers in the array into `bucket_count` equal-width buckets.
+ * Bucket `i` counts values in `[low + i * bucket_width, low + (i + 1) * bucket_width)`.
+ * Values outside all buckets are not counted.
+ * @param buckets an array of `bucket_count` counters. Counts are added to
+ *                its existing contents, so zero it for a fresh histogram.
+ * @note if `bucket_width` is 0, this function prints an error and exits.
+ * @note `O(n)`. With a power-of-two `bucket_width`, bucket indices are
+ *       computed with AVX2 when available; other widths need a 64-bit
+ *       division, which AVX2 lacks, and stay scalar. The increments
+ *       themselves are random-access writes and are always scalar.
+ */
+void hharray_i64_histogram(HHArray array, int64_t low, uint64_t bucket_width,
+                           size_t *buckets, size_t bucket_count);
+
+/**
+ * Replaces each integer in the array with the sum of itself and every
+ * integer before it (an inclusive prefix sum), wrapping on overflow.
+ * @note `O(n)`, vectorized with AVX2 when available.
+ */
+void hharray_i64_prefix_sum(HHArray array);
+
+#endif /* defined(__HHArray__HHArrayInt__) */
@@ -0,0 +1,68 @@
+//
+//  HHArrayPolicy.h
+//  HHArray
+//
+//  The growth policy and error handling shared by HHArray and the
+//  typed arrays generated by HHArrayTyped.h, so both resize alike.
+//
+
+#ifndef __HHArray__HHArrayPolicy__
+#define __HHArray__HHArrayPolicy__
+
+#include <stdlib.h>
+
+#define HHARRAY_DEFAULT_CAPACITY 10
+#define HHARRAY_RESIZE_FACTOR 1.5
+#define HHARRAY_LOAD_THRESHOLD 0.75
+
+// See the build modes described in HHArray.h.
+#if defined(HHARRAY_CHECKED)
+#define HHARRAY_EXIT_WITH_FAILURE abort()
+#elif defined(UNIT_TEST)
+#define HHARRAY_EXIT_WITH_FAILURE exit(EXIT_FAILURE)
+#else
+#define HHARRAY_EXIT_WITH_FAILURE
+#endif
+
+/**
+ * @return whether an array holding `size` values in `capacity` slots is
+ *         past the load threshold, and should grow before its next insertion.
+ */
+static inline int hharray_policy_should_grow(size_t size, size_t capacity) {
+    return ((double)size / (double)capacity) > HHARRAY_LOAD_THRESHOLD;
+}
+
+/**
+ * @return the capacity an array of `capacity` slots grows to.
+ */
+static inline size_t hharray_policy_grown_capacity(size_t capacity) {
+    return capacity * HHARRAY_RESIZE_FACTOR;
+}
+
+/**
+ * @return the capacity an array of `capacity` slots shrinks to.
+ */
+static inline size_t hharray_policy_shrunk_capacity(size_t capacity) {
+    return capacity / HHARRAY_RESIZE_FACTOR;
+}
+
+/**
+ * @return whether shrinking an array of `size` values in `capacity` slots
+ *         keeps it within the load threshold.
+ */
+static inline int hharray_policy_should_shrink(size_t size, size_t capacity) {
+    size_t capacity_after_shrink = hharray_policy_shrunk_capacity(capacity);
+    double load_after_shrink = (double)size / (double)capacity_after_shrink;
+    return load_after_shrink < HHARRAY_LOAD_THRESHOLD && capacity_after_shrink > 0;
+}
+
+/**
+ * @return the capacity for a new array about to hold `count` values,
+ *         leaving room for appends before its first growth.
+ */
+static inline size_t hharray_policy_capacity_for(size_t count) {
+    size_t capacity = count / HHARRAY_LOAD_THRESHOLD;
+    return capacity > HHARRAY_DEFAULT_CAPACITY ? capacity : HHARRAY_DEFAULT_CAPACITY;
+}
+
+#endif /* defined(__HHArray__HHArrayPolicy__) */
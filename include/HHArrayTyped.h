@@ -0,0 +1,371 @@
+//
+//  HHArrayTyped.h
+//  HHArray
+//
+//  Header-only arrays that store values of a given type inline, rather
+//  than as `void *` slots. They follow HHArray's growth policy and error
+//  handling. To use one, declare it where its clients can see it:
+//
+//      HHARRAY_DECLARE(point_array, Point)
+//
+//  then define it once, in a single source file:
+//
+//      HHARRAY_DEFINE(point_array, Point)
+//      HHARRAY_DEFINE_SORT(point_array, point_less)
+//
+//  This generates the type `point_array` and the functions
+//  `point_array_create()`, `point_array_append()` and so on, mirroring
+//  the HHArray functions of the same names. `point_less(a, b)` is a
+//  function or macro taking two `const Point *`, called directly by the
+//  generated sort so that the comparison can be inlined.
+//
+
+#ifndef __HHArray__HHArrayTyped__
+#define __HHArray__HHArrayTyped__
+
+#include <stdio.h>
+#include <string.h>
+#include "HHArrayPolicy.h"
+#include "utilities.h"
+
+#define HHARRAY_TYPED_INSERTION_SORT_THRESHOLD 16
+
+/**
+ * Checks that `index` is less than `count`, and otherwise causes an error and exits.
+ * @return non-zero if `index` is valid.
+ */
+static inline int hharray_typed_check_index(size_t count, size_t index) {
+#ifdef HHARRAY_UNCHECKED
+    (void)count;
+    (void)index;
+    return 1;
+#else
+    if (__builtin_expect(index < count, 1)) return 1;
+    fprintf(stderr, "Array index %zu out of bounds for size %zu.", index, count);
+    HHARRAY_EXIT_WITH_FAILURE;
+    return 0;
+#endif
+}
+
+/**
+ * Declares the typed array `Name` holding values of type `T`, and its functions.
+ * The struct's fields are private; use the functions instead.
+ */
+#define HHARRAY_DECLARE(Name, T)                                                          \
+    typedef T Name##_value;                                                               \
+    typedef struct Name##_S {                                                             \
+        size_t size;                                                                      \
+        size_t capacity;                                                                  \
+        T *values;                                                                        \
+    } * Name;                                                                             \
+    Name Name##_create_capacity(size_t capacity);                                         \
+    Name Name##_create(void);                                                             \
+    Name Name##_copy(Name array);                                                         \
+    void Name##_destroy(Name array);                                                      \
+    size_t Name##_size(Name array);                                                       \
+    T *Name##_values(Name array);                                                         \
+    T Name##_get(Name array, size_t index);                                               \
+    T *Name##_slot(Name array, size_t index);                                             \
+    void Name##_set(Name array, size_t index, T value);                                   \
+    void Name##_append(Name array, T value);                                              \
+    void Name##_append_list(Name dest, Name source);                                      \
+    void Name##_insert_index(Name array, T value, size_t index);                          \
+    void Name##_insert_list(Name dest, Name source, size_t index);                        \
+    T Name##_remove_index(Name array, size_t index);                                      \
+    T Name##_remove_last(Name array);                                                     \
+    void Name##_swap(Name array, size_t first_index, size_t second_index);                \
+    void Name##_reverse(Name array);                                                      \
+    Name Name##_slice(Name array, size_t start, size_t end);                              \
+    Name Name##_map(Name array, T (*transform)(const T *value));                          \
+    Name Name##_filter(Name array, int (*include)(const T *value));                       \
+    T Name##_reduce(Name array, T initial, T (*combine)(T accumulated, const T *value));  \
+    void Name##_sort(Name array);
+
+/**
+ * Defines the functions declared by `HHARRAY_DECLARE(Name, T)`, except for
+ * `Name##_sort()`, which `HHARRAY_DEFINE_SORT()` defines.
+ * Each behaves like the HHArray function of the same name, with values
+ * passed and returned by value. `Name##_slot()` returns the address of a
+ * value, which stays valid until the array next grows or shrinks.
+ * `Name##_remove_last()` removes from the end in `O(1)`.
+ * Functions that fail return a zeroed `T`.
+ */
+#define HHARRAY_DEFINE(Name, T)                                                           \
+    static inline T Name##_zero_(void) {                                                  \
+        T zero;                                                                           \
+        memset(&zero, 0, sizeof(T));                                                      \
+        return zero;                                                                      \
+    }                                                                                     \
+                                                                                          \
+    static void Name##_resize_(Name array, size_t capacity) {                             \
+        array->values = hhrealloc(array->values, capacity * sizeof(T));                   \
+        array->capacity = capacity;                                                       \
+    }                                                                                     \
+                                                                                          \
+    static void Name##_ensure_capacity_(Name array, size_t capacity) {                    \
+        if (array->capacity < capacity) Name##_resize_(array, capacity);                  \
+    }                                                                                     \
+                                                                                          \
+    static void Name##_grow_if_needed_(Name array) {                                      \
+        if (hharray_policy_should_grow(array->size, array->capacity)) {                   \
+            Name##_resize_(array, hharray_policy_grown_capacity(array->capacity));        \
+        }                                                                                 \
+    }                                                                                     \
+                                                                                          \
+    Name Name##_create_capacity(size_t capacity) {                                        \
+        if (capacity == 0) {                                                              \
+            fputs("Cannot initialize an hharray with capacity 0.\n", stderr);             \
+            HHARRAY_EXIT_WITH_FAILURE;                                                    \
+        }                                                                                 \
+        if (capacity < HHARRAY_DEFAULT_CAPACITY) capacity = HHARRAY_DEFAULT_CAPACITY;     \
+        Name array = hhmalloc(sizeof(struct Name##_S));                                   \
+        array->capacity = capacity;                                                       \
+        array->values = hhcalloc(capacity, sizeof(T));                                    \
+        return array;                                                                     \
+    }                                                                                     \
+                                                                                          \
+    Name Name##_create(void) {                                                            \
+        return Name##_create_capacity(HHARRAY_DEFAULT_CAPACITY);                          \
+    }                                                                                     \
+                                                                                          \
+    Name Name##_copy(Name array) {                                                        \
+        return Name##_slice(array, 0, array->size);                                       \
+    }                                                                                     \
+                                                                                          \
+    void Name##_destroy(Name array) {                                                     \
+        free(array->values);                                                              \
+        free(array);                                                                      \
+    }                                                                                     \
+                                                                                          \
+    size_t Name##_size(Name array) {                                                      \
+        return array->size;                                                               \
+    }                                                                                     \
+                                                                                          \
+    T *Name##_values(Name array) {                                                        \
+        return array->values;                                                             \
+    }                                                                                     \
+                                                                                          \
+    T Name##_get(Name array, size_t index) {                                              \
+        if (!hharray_typed_check_index(array->size, index)) return Name##_zero_();        \
+        return array->values[index];                                                      \
+    }                                                                                     \
+                                                                                          \
+    T *Name##_slot(Name array, size_t index) {                                            \
+        if (!hharray_typed_check_index(array->size, index)) return NULL;                  \
+        return &array->values[index];                                                     \
+    }                                                                                     \
+                                                                                          \
+    void Name##_set(Name array, size_t index, T value) {                                  \
+        if (!hharray_typed_check_index(array->size, index)) return;                       \
+        array->values[index] = value;                                                     \
+    }                                                                                     \
+                                                                                          \
+    void Name##_append(Name array, T value) {                                             \
+        Name##_grow_if_needed_(array);                                                    \
+        array->values[array->size++] = value;                                             \
+    }                                                                                     \
+                                                                                          \
+    void Name##_insert_list(Name dest, Name source, size_t index) {                       \
+        if (!hharray_typed_check_index(dest->size + 1, index)) return;                    \
+        size_t count = source->size;                                                      \
+        Name##_ensure_capacity_(dest, dest->size + count);                                \
+        memmove(&dest->values[index + count], &dest->values[index],                       \
+                (dest->size - index) * sizeof(T));                                        \
+        /* When inserting an array into itself, the source has just moved. */             \
+        if (source == dest) {                                                             \
+            memcpy(&dest->values[index], dest->values, index * sizeof(T));                \
+            memcpy(&dest->values[2 * index], &dest->values[index + count],                \
+                   (count - index) * sizeof(T));                                          \
+        } else if (count > 0) {                                                           \
+            memcpy(&dest->values[index], source->values, count * sizeof(T));              \
+        }                                                                                 \
+        dest->size += count;                                                              \
+    }                                                                                     \
+                                                                                          \
+    void Name##_append_list(Name dest, Name source) {                                     \
+        Name##_insert_list(dest, source, dest->size);                                     \
+    }                                                                                     \
+                                                                                          \
+    void Name##_insert_index(Name array, T value, size_t index) {                         \
+        if (!hharray_typed_check_index(array->size + 1, index)) return;                   \
+        Name##_grow_if_needed_(array);                                                    \
+        memmove(&array->values[index + 1], &array->values[index],                         \
+                (array->size - index) * sizeof(T));                                       \
+        array->values[index] = value;                                                     \
+        array->size++;                                                                    \
+    }                                                                                     \
+                                                                                          \
+    T Name##_remove_index(Name array, size_t index) {                                     \
+        if (!hharray_typed_check_index(array->size, index)) return Name##_zero_();        \
+        T value = array->values[index];                                                   \
+        array->size--;                                                                    \
+        if (index == array->size) return value;                                           \
+        memmove(&array->values[index], &array->values[index + 1],                         \
+                (array->size - index) * sizeof(T));                                       \
+        if (hharray_policy_should_shrink(array->size, array->capacity)) {                 \
+            Name##_resize_(array, hharray_policy_shrunk_capacity(array->capacity));       \
+        }                                                                                 \
+        return value;                                                                     \
+    }                                                                                     \
+                                                                                          \
+    T Name##_remove_last(Name array) {                                                    \
+        if (array->size == 0) {                                                           \
+            fputs("Cannot remove from an empty array.\n", stderr);                        \
+            HHARRAY_EXIT_WITH_FAILURE;                                                    \
+            return Name##_zero_();                                                        \
+        }                                                                                 \
+        return array->values[--array->size];                                              \
+    }                                                                                     \
+                                                                                          \
+    void Name##_swap(Name array, size_t first_index, size_t second_index) {               \
+        if (!hharray_typed_check_index(array->size, first_index) ||                       \
+            !hharray_typed_check_index(array->size, second_index)) return;                \
+        T tmp = array->values[first_index];                                               \
+        array->values[first_index] = array->values[second_index];                         \
+        array->values[second_index] = tmp;                                                \
+    }                                                                                     \
+                                                                                          \
+    void Name##_reverse(Name array) {                                                     \
+        for (size_t i = 0, j = array->size; i + 1 < j; i++, j--) {                        \
+            T tmp = array->values[i];                                                     \
+            array->values[i] = array->values[j - 1];                                      \
+            array->values[j - 1] = tmp;                                                   \
+        }                                                                                 \
+    }                                                                                     \
+                                                                                          \
+    Name Name##_slice(Name array, size_t first, size_t second) {                          \
+        size_t start = first < second ? first : second;                                   \
+        size_t end = first < second ? second : first;                                     \
+        if (!hharray_typed_check_index(array->size + 1, end)) return Name##_create();     \
+        size_t count = end - start;                                                       \
+        Name new = Name##_create_capacity(hharray_policy_capacity_for(count));            \
+        memcpy(new->values, &array->values[start], count * sizeof(T));                    \
+        new->size = count;                                                                \
+        if (first > second) {                                                             \
+            Name##_reverse(new);                                                          \
+        }                                                                                 \
+        return new;                                                                       \
+    }                                                                                     \
+                                                                                          \
+    Name Name##_map(Name array, T (*transform)(const T *value)) {                         \
+        Name new = Name##_create_capacity(hharray_policy_capacity_for(array->size));      \
+        for (size_t i = 0; i < array->size; i++) {                                        \
+            new->values[i] = transform(&array->values[i]);                                \
+        }                                                                                 \
+        new->size = array->size;                                                          \
+        return new;                                                                       \
+    }                                                                                     \
+                                                                                          \
+    Name Name##_filter(Name array, int (*include)(const T *value)) {                      \
+        Name new = Name##_create();                                                       \
+        for (size_t i = 0; i < array->size; i++) {                                        \
+            if (include(&array->values[i])) {                                             \
+                Name##_append(new, array->values[i]);                                     \
+            }                                                                             \
+        }                                                                                 \
+        return new;                                                                       \
+    }                                                                                     \
+                                                                                          \
+    T Name##_reduce(Name array, T initial, T (*combine)(T accumulated, const T *value)) { \
+        T accumulated = initial;                                                          \
+        for (size_t i = 0; i < array->size; i++) {                                        \
+            accumulated = combine(accumulated, &array->values[i]);                        \
+        }                                                                                 \
+        return accumulated;                                                               \
+    }
+
+/**
+ * Defines `Name##_sort()` for a typed array declared with `HHARRAY_DECLARE`,
+ * ordering values with `less(const T *a, const T *b)`.
+ * The sort is an introsort: quicksort with a median-of-three pivot,
+ * falling back to heapsort when recursion gets too deep, and finishing
+ * small ranges with insertion sort.
+ * @note `O(n*log(n))`, not stable.
+ */
+#define HHARRAY_DEFINE_SORT(Name, less)                                                   \
+    static void Name##_insertion_sort_(Name##_value *values, size_t count) {              \
+        for (size_t i = 1; i < count; i++) {                                              \
+            Name##_value value = values[i];                                               \
+            size_t j = i;                                                                 \
+            for (; j > 0 && less(&value, &values[j - 1]); j--) {                          \
+                values[j] = values[j - 1];                                                \
+            }                                                                             \
+            values[j] = value;                                                            \
+        }                                                                                 \
+    }                                                                                     \
+                                                                                          \
+    static void Name##_sift_down_(Name##_value *values, size_t index, size_t count) {     \
+        Name##_value value = values[index];                                               \
+        size_t child;                                                                     \
+        while ((child = 2 * index + 1) < count) {                                         \
+            if (child + 1 < count && less(&values[child], &values[child + 1])) child++;   \
+            if (!less(&value, &values[child])) break;                                     \
+            values[index] = values[child];                                                \
+            index = child;                                                                \
+        }                                                                                 \
+        values[index] = value;                                                            \
+    }                                                                                     \
+                                                                                          \
+    static void Name##_heap_sort_(Name##_value *values, size_t count) {                   \
+        for (size_t i = count / 2; i-- > 0;) {                                            \
+            Name##_sift_down_(values, i, count);                                          \
+        }                                                                                 \
+        for (size_t end = count; end-- > 1;) {                                            \
+            Name##_value tmp = values[0];                                                 \
+            values[0] = values[end];                                                      \
+            values[end] = tmp;                                                            \
+            Name##_sift_down_(values, 0, end);                                            \
+        }                                                                                 \
+    }                                                                                     \
+                                                                                          \
+    static inline void Name##_order_(Name##_value *a, Name##_value *b) {                  \
+        if (less(b, a)) {                                                                 \
+            Name##_value tmp = *a;                                                        \
+            *a = *b;                                                                      \
+            *b = tmp;                                                                     \
+        }                                                                                 \
+    }                                                                                     \
+                                                                                          \
+    static void Name##_introsort_(Name##_value *values, size_t count, size_t depth) {     \
+        while (count > HHARRAY_TYPED_INSERTION_SORT_THRESHOLD) {                          \
+            if (depth-- == 0) {                                                           \
+                Name##_heap_sort_(values, count);                                         \
+                return;                                                                   \
+            }                                                                             \
+            /* Ordering the ends keeps both partitions non-empty. */                      \
+            size_t middle = count / 2;                                                    \
+            Name##_order_(&values[0], &values[middle]);                                   \
+            Name##_order_(&values[middle], &values[count - 1]);                           \
+            Name##_order_(&values[0], &values[middle]);                                   \
+            Name##_value pivot = values[middle];                                          \
+            size_t i = 0;                                                                 \
+            size_t j = count - 1;                                                         \
+            for (;;) {                                                                    \
+                while (less(&values[i], &pivot)) i++;                                     \
+                while (less(&pivot, &values[j])) j--;                                     \
+                if (i >= j) break;                                                        \
+                Name##_value tmp = values[i];                                             \
+                values[i++] = values[j];                                                  \
+                values[j--] = tmp;                                                        \
+            }                                                                             \
+            /* Recurse into the smaller side, and loop over the larger. */                \
+            size_t split = j + 1;                                                         \
+            if (split < count - split) {                                                  \
+                Name##_introsort_(values, split, depth);                                  \
+                values += split;                                                          \
+                count -= split;                                                           \
+            } else {                                                                      \
+                Name##_introsort_(values + split, count - split, depth);                  \
+                count = split;                                                            \
+            }                                                                             \
+        }                                                                                 \
+        Name##_insertion_sort_(values, count);                                            \
+    }                                                                                     \
+                                                                                          \
+    void Name##_sort(Name array) {                                                        \
+        size_t depth = 0;                                                                 \
+        for (size_t n = array->size; n > 1; n >>= 1) depth += 2;                          \
+        Name##_introsort_(array->values, array->size, depth);                             \
+    }
+
+#endif /* defined(__HHArray__HHArrayTyped__) */
@@ -0,0 +1,80 @@
+//
+//  HHCompressedArray.h
+//  HHArray
+//
+//  An immutable, compressed copy of a sorted integer HHArray, i.e. one
+//  filled with `hharray_append(array, (void *)(long)value)` in ascending
+//  order. Values are stored as bit-packed deltas in blocks of 128, with a
+//  skip index holding the first value of every block.
+//
+
+#ifndef __HHArray__HHCompressedArray__
+#define __HHArray__HHCompressedArray__
+
+#include <stdint.h>
+#include "HHArray.h"
+
+#ifndef _HHCOMPRESSEDARRAY_DEFINED_
+typedef struct { } *HHCompressedArray;
+#endif
+
+/**
+ * Compresses a sorted integer array. Each block of 128 values stores the
+ * gaps between neighbours using only as many bits as its largest gap
+ * needs, so dense IDs take one or two bytes per value instead of eight.
+ * @param array an array whose integers are in ascending order. It is not
+ *              modified, and can be destroyed once frozen.
+ * @return the compressed array, or NULL if `array` is not sorted.
+ * @note if `array` is not sorted, this function prints an error and exits.
+ * @note `O(n)`
+ */
+HHCompressedArray hharray_freeze_compressed(HHArray array);
+
+/**
+ * Frees a compressed array.
+ * @note `O(1)`
+ */
+void hharray_compressed_destroy(HHCompressedArray array);
+
+/**
+ * @return the number of values stored in the array.
+ * @note `O(1)`
+ */
+size_t hharray_compressed_size(HHCompressedArray array);
+
+/**
+ * @return the number of bytes the array occupies, including its skip index.
+ * @note `O(1)`
+ */
+size_t hharray_compressed_memory(HHCompressedArray array);
+
+/**
+ * @return the integer at `index`.
+ * @note if `index` is out of bounds, this function prints an error and exits.
+ * @note `O(1)`: decodes at most one block of 128 values.
+ */
+int64_t hharray_compressed_get(HHCompressedArray array, size_t index);
+
+/**
+ * @return the index of the first value not less than `value`,
+ *         or the array's size if every value is less.
+ * @note `O(log(n))`: a binary search of the skip index, then one block decode.
+ */
+size_t hharray_compressed_lower_bound(HHCompressedArray array, int64_t value);
+
+/**
+ * Decodes `count` consecutive values starting at `start` into `out`.
+ * Decoding a block at a time is the fastest way to iterate.
+ * @return the number of values written, which is less than `count`
+ *         if the range runs past the end of the array.
+ * @note `O(count)`, unpacked with AVX2 when available.
+ */
+size_t hharray_compressed_decode(HHCompressedArray array, size_t start, int64_t *out, size_t count);
+
+/**
+ * Decompresses the array back into a new HHArray of integer slots.
+ * @note `O(n)`
+ */
+HHArray hharray_compressed_thaw(HHCompressedArray array);
+
+#endif /* defined(__HHArray__HHCompressedArray__) */
@@ -0,0 +1,124 @@
+//
+//  HHConcurrentArray.h
+//  HHArray
+//
+//  A resizable array that many threads can read while one thread at a time
+//  writes. Readers never lock: writers publish a new buffer with an atomic
+//  pointer swap, and old buffers are freed once no reader can still see
+//  them (epoch-based reclamation).
+//
+
+#ifndef __HHArray__HHConcurrentArray__
+#define __HHArray__HHConcurrentArray__
+
+#include <stdio.h>
+#include "HHArray.h"
+
+#ifndef _HHCONCURRENTARRAY_DEFINED_
+typedef struct { } *HHConcurrentArray;
+typedef struct { } *HHConcurrentReader;
+#endif
+
+/**
+ * Initializes an empty concurrent array.
+ * @param capacity the initial capacity, as in `hharray_create_capacity()`.
+ * @param max_readers the most reader handles that can be registered at once.
+ * @note `O(max_readers)`
+ */
+HHConcurrentArray hharray_concurrent_create(size_t capacity, size_t max_readers);
+
+/**
+ * Frees a concurrent array and every buffer it still holds.
+ * @pre no reader handles are registered and no thread is writing.
+ * @note This does not free any of the values contained in the array.
+ */
+void hharray_concurrent_destroy(HHConcurrentArray array);
+
+/**
+ * Registers a reader handle for the calling thread.
+ * A handle must only be used by one thread at a time.
+ * @return a handle, or NULL if `max_readers` handles are already registered.
+ * @note `O(max_readers)`
+ */
+HHConcurrentReader hharray_concurrent_reader_register(HHConcurrentArray array);
+
+/**
+ * Releases a reader handle so its slot can be registered again.
+ * @pre the handle is not inside a read section.
+ */
+void hharray_concurrent_reader_release(HHConcurrentReader reader);
+
+/**
+ * Begins a read section. Until `hharray_concurrent_read_end()`, the reader
+ * sees one buffer that no writer will free, without taking any lock or
+ * performing any atomic read-modify-write.
+ * Values appended or set during the section may or may not be visible.
+ * @note `O(1)`
+ */
+void hharray_concurrent_read_begin(HHConcurrentReader reader);
+
+/**
+ * Ends a read section, allowing writers to free buffers the reader saw.
+ * Keep sections short; a reader that stays in a section holds back reclamation.
+ * @note `O(1)`
+ */
+void hharray_concurrent_read_end(HHConcurrentReader reader);
+
+/**
+ * @return the number of items in the array as seen by the reader.
+ * @pre called inside a read section.
+ * @note `O(1)`
+ */
+size_t hharray_concurrent_size(HHConcurrentReader reader);
+
+/**
+ * @return the value held at `index`, as seen by the reader.
+ * @pre called inside a read section.
+ * @note if `index` is not a valid index, this function prints an error and exits.
+ * @note `O(1)`
+ */
+void *hharray_concurrent_get(HHConcurrentReader reader, size_t index);
+
+/**
+ * Searches the array as seen by the reader, like `hharray_find_f()`.
+ * @pre called inside a read section.
+ * @note `O(n)`
+ */
+size_t hharray_concurrent_find_f(HHConcurrentReader reader, void *element, int (*is_equal)(void *, void *));
+
+/**
+ * Appends the `value` at the end of the array's storage.
+ * Writes in place when there's room, and otherwise publishes a larger buffer.
+ * @note `O(1)` amortized.
+ */
+void hharray_concurrent_append(HHConcurrentArray array, void *value);
+
+/**
+ * Replaces the value held at `index` in place.
+ * @note if `index` is not a valid index, this function prints an error and exits.
+ * @note `O(1)`
+ */
+void hharray_concurrent_set(HHConcurrentArray array, size_t index, void *value);
+
+/**
+ * Inserts the provided value at a given index, by publishing a new buffer.
+ * @note if `index` is greater than the array's size, this function prints an error and exits.
+ * @note `O(n)`
+ */
+void hharray_concurrent_insert_index(HHConcurrentArray array, void *value, size_t index);
+
+/**
+ * Removes the value at `index`, by publishing a new buffer.
+ * @return the removed value.
+ * @note if `index` is not a valid index, this function prints an error and exits.
+ * @note `O(n)`
+ */
+void *hharray_concurrent_remove_index(HHConcurrentArray array, size_t index);
+
+/**
+ * Copies the array's current contents into a new HHArray.
+ * @note `O(n)`
+ */
+HHArray hharray_concurrent_copy(HHConcurrentArray array);
+
+#endif /* defined(__HHArray__HHConcurrentArray__) */
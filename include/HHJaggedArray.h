@@ -0,0 +1,119 @@
+//
+//  HHJaggedArray.h
+//  HHArray
+//
+//  An array of variable-length rows, stored in compressed sparse row
+//  (CSR) layout: every row's values sit back to back in one buffer, and a
+//  second buffer holds the offset at which each row starts. This takes
+//  one slot per value plus one offset per row, and a scan over every row
+//  reads memory sequentially.
+//
+
+#ifndef __HHArray__HHJaggedArray__
+#define __HHArray__HHJaggedArray__
+
+#include <stdio.h>
+#include "HHArray.h"
+
+#ifndef _HHJAGGEDARRAY_DEFINED_
+typedef struct { } *HHJaggedArray;
+#endif
+
+/**
+ * Initializes a jagged array with no rows.
+ * @note `O(1)`
+ */
+HHJaggedArray hharray_jagged_create();
+
+/**
+ * Builds a jagged array whose rows have the given sizes, filling the rows
+ * from up to `threads` threads at once.
+ * Rows are split between threads so that each fills about the same number
+ * of values.
+ * @param counts the number of values in each row.
+ * @param fill called once per row with the row's storage, which it must
+ *             fill with `count` values. Calls may happen concurrently.
+ * @note `O(n / threads + row_count)`
+ */
+HHJaggedArray hharray_jagged_build(const size_t *counts, size_t row_count,
+                                   void (*fill)(size_t row, void **values, size_t count, void *context),
+                                   void *context, size_t threads);
+
+/**
+ * Frees a jagged array.
+ * @note This does not free any of the values contained in the array.
+ * @note `O(1)`
+ */
+void hharray_jagged_destroy(HHJaggedArray array);
+
+/**
+ * @return the number of rows in the array.
+ * @note `O(1)`
+ */
+size_t hharray_jagged_row_count(HHJaggedArray array);
+
+/**
+ * @return the number of values in all rows combined.
+ * @note `O(1)`
+ */
+size_t hharray_jagged_size(HHJaggedArray array);
+
+/**
+ * Appends a new last row holding `count` values.
+ * @param values the row's values. May be NULL if `count` is 0.
+ * @note amortized `O(count)`
+ */
+void hharray_jagged_append_row(HHJaggedArray array, void *const *values, size_t count);
+
+/**
+ * Appends the `value` at the end of the last row.
+ * @note if the array has no rows, this function prints an error and exits.
+ * @note amortized `O(1)`
+ */
+void hharray_jagged_append(HHJaggedArray array, void *value);
+
+/**
+ * @return a view of the values in `row`, which stays valid until the
+ *         array is next appended to. Its values can be modified in place.
+ * @param count receives the number of values in the row.
+ * @note if `row` is out of bounds, this function prints an error and exits.
+ * @note `O(1)`
+ */
+void **hharray_jagged_row(HHJaggedArray array, size_t row, size_t *count);
+
+/**
+ * @return the number of values in `row`.
+ * @note if `row` is out of bounds, this function prints an error and exits.
+ * @note `O(1)`
+ */
+size_t hharray_jagged_row_size(HHJaggedArray array, size_t row);
+
+/**
+ * @return the value at `column` in `row`.
+ * @note if either index is out of bounds, this function prints an error and exits.
+ * @note `O(1)`
+ */
+void *hharray_jagged_get(HHJaggedArray array, size_t row, size_t column);
+
+/**
+ * Calls `visit` with each row in order, scanning the values sequentially.
+ * @note `O(n + row_count)`
+ */
+void hharray_jagged_for_each(HHJaggedArray array,
+                             void (*visit)(size_t row, void **values, size_t count, void *context),
+                             void *context);
+
+/**
+ * Builds a jagged array from an HHArray whose values are HHArrays, one per row.
+ * The nested arrays are not modified.
+ * @note `O(n + row_count)`
+ */
+HHJaggedArray hharray_jagged_from_nested(HHArray rows);
+
+/**
+ * Copies a jagged array into an HHArray holding one new HHArray per row.
+ * @note `O(n + row_count)`
+ */
+HHArray hharray_jagged_to_nested(HHJaggedArray array);
+
+#endif /* defined(__HHArray__HHJaggedArray__) */
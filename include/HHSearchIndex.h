@@ -0,0 +1,80 @@
+//
+//  HHSearchIndex.h
+//  HHArray
+//
+//  A read-only search index over a sorted HHArray. The values are copied
+//  in Eytzinger (breadth-first) order, so the first levels of every search
+//  share a few cache lines, and the next levels can be prefetched while
+//  the current one is compared.
+//
+
+#ifndef __HHArray__HHSearchIndex__
+#define __HHArray__HHSearchIndex__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "HHArray.h"
+
+#ifndef _HHSEARCHINDEX_DEFINED_
+typedef struct { } *HHSearchIndex;
+#endif
+
+/**
+ * Builds a search index over a sorted array.
+ * The index holds a copy of the values, and nothing else, so it stays
+ * valid after `array` is modified or destroyed, but won't see the changes.
+ * @param array an array sorted according to `comparison`.
+ * @param comparison a `qsort`-style comparison, which receives pointers to
+ *                   the values being compared.
+ * @return the index, or NULL if `array` is not sorted.
+ * @note if `array` is not sorted, this function prints an error and exits.
+ * @note `O(n)`
+ */
+HHSearchIndex hharray_build_search_index(HHArray array, int (*comparison)(const void *a, const void *b));
+
+/**
+ * Builds a search index over an array whose slots hold integers, as in
+ * HHArrayInt.h, sorted in ascending order. Lookups compare the integers
+ * inline instead of calling a comparison function.
+ * @return the index, or NULL if `array` is not sorted.
+ * @note if `array` is not sorted, this function prints an error and exits.
+ * @note `O(n)`
+ */
+HHSearchIndex hharray_build_search_index_i64(HHArray array);
+
+/**
+ * Frees a search index.
+ * @note This does not free any of the values contained in the index.
+ * @note `O(1)`
+ */
+void hharray_index_destroy(HHSearchIndex index);
+
+/**
+ * @return the number of values in the index.
+ * @note `O(1)`
+ */
+size_t hharray_index_size(HHSearchIndex index);
+
+/**
+ * @return the position, in the array the index was built from, of the
+ *         first value not less than `value`, or the array's size if every
+ *         value is less.
+ * @note `O(log(n))`, descending without branching on the comparisons.
+ */
+size_t hharray_index_lower_bound(HHSearchIndex index, void *value);
+
+/**
+ * @return the position, in the array the index was built from, of the
+ *         first value equal to `value`, or `HHArrayNotFound`.
+ * @note `O(log(n))`
+ */
+size_t hharray_index_find(HHSearchIndex index, void *value);
+
+/**
+ * `hharray_index_lower_bound()` for an integer `value`, typically on an
+ * index built with `hharray_build_search_index_i64()`.
+ * @note `O(log(n))`
+ */
+size_t hharray_index_lower_bound_i64(HHSearchIndex index, int64_t value);
+
+#endif /* defined(__HHArray__HHSearchIndex__) */
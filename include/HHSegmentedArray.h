@@ -0,0 +1,124 @@
+//
+//  HHSegmentedArray.h
+//  HHArray
+//
+//  A resizable array stored in segments that never move, so appending
+//  never copies existing values and the address of a slot stays valid
+//  for the life of the array.
+//
+
+#ifndef __HHArray__HHSegmentedArray__
+#define __HHArray__HHSegmentedArray__
+
+#include <stdio.h>
+#include "HHArray.h"
+
+#ifndef _HHSEGMENTEDARRAY_DEFINED_
+typedef struct { } *HHSegmentedArray;
+#endif
+
+/**
+ * Initializes an empty segmented array.
+ * Segments double in size as the array grows: the first holds 16 values,
+ * the next 32, and so on, so a small directory covers any size.
+ * @note `O(1)`
+ */
+HHSegmentedArray hharray_segmented_create();
+
+/**
+ * Frees a segmented array and all of its segments.
+ * @note This does not free any of the values contained in the array.
+ * @note `O(log(n))`
+ */
+void hharray_segmented_destroy(HHSegmentedArray array);
+
+/**
+ * @return the number of items currently stored in the array.
+ * @note `O(1)`
+ */
+size_t hharray_segmented_size(HHSegmentedArray array);
+
+/**
+ * Appends the `value` at the end of the array's storage.
+ * When the last segment is full a new one is allocated; existing values
+ * are never copied.
+ * @note `O(1)` worst case, aside from the allocation of a new segment.
+ */
+void hharray_segmented_append(HHSegmentedArray array, void *value);
+
+/**
+ * Removes the last value from the array.
+ * @return the removed value.
+ * @note if the array is empty, this function prints an error and exits.
+ * @note `O(1)`. Segments are kept for reuse until the array is destroyed.
+ */
+void *hharray_segmented_remove_last(HHSegmentedArray array);
+
+/**
+ * @return the value held at `index` in the array.
+ * @note if the array is smaller than the requested index,
+ *       this function prints an error and exits.
+ * @note `O(1)`, using a bit scan of the index to find its segment.
+ */
+void *hharray_segmented_get(HHSegmentedArray array, size_t index);
+
+/**
+ * Replaces the value held at `index` in the array.
+ * @note if the array is smaller than the requested index,
+ *       this function prints an error and exits.
+ * @note `O(1)`
+ */
+void hharray_segmented_set(HHSegmentedArray array, size_t index, void *value);
+
+/**
+ * @return the address of the slot at `index`. The address stays valid
+ *         until the array is destroyed, however much the array grows.
+ * @note if the array is smaller than the requested index,
+ *       this function prints an error and exits.
+ * @note `O(1)`
+ */
+void **hharray_segmented_slot(HHSegmentedArray array, size_t index);
+
+/**
+ * @return the number of segments holding at least one value.
+ * @note `O(1)`
+ */
+size_t hharray_segmented_segment_count(HHSegmentedArray array);
+
+/**
+ * Returns one segment's values, for iterating the array a segment at a time.
+ * @param segment the segment, from 0 to `hharray_segmented_segment_count() - 1`.
+ * @param count receives the number of values in the segment.
+ * @return a pointer to the segment's first value.
+ * @note `O(1)`
+ */
+void **hharray_segmented_segment(HHSegmentedArray array, size_t segment, size_t *count);
+
+/**
+ * Creates a new segmented array containing the result of applying
+ * `transform` to all elements in the provided array, in order.
+ * @note `O(n)`
+ */
+HHSegmentedArray hharray_segmented_map(HHSegmentedArray array, void *(*transform)(void *));
+
+/**
+ * Creates a new segmented array containing only the elements of `array`
+ * that returned non-zero from the provided `include` function.
+ * @note `O(n)`
+ */
+HHSegmentedArray hharray_segmented_filter(HHSegmentedArray array, int (*include)(void *));
+
+/**
+ * Continually applies `combine` to sequential values in the
+ * array, 'reducing' it to one value.
+ * @note `O(n)`
+ */
+void *hharray_segmented_reduce(HHSegmentedArray array, void *initial, void *(*combine)(void *, void *));
+
+/**
+ * Copies the contents of a segmented array into a new, contiguous HHArray.
+ * @note `O(n)`
+ */
+HHArray hharray_segmented_to_array(HHSegmentedArray array);
+
+#endif /* defined(__HHArray__HHSegmentedArray__) */
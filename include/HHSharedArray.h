@@ -0,0 +1,136 @@
+//
+//  HHSharedArray.h
+//  HHArray
+//
+//  A resizable array of 64-bit integers in POSIX shared memory, so that
+//  processes can hand arrays to each other without copying. Slots hold
+//  integers rather than pointers, since a pointer is only meaningful in
+//  the process that made it; store offsets or IDs instead.
+//
+//  Any process may append, one at a time. Growing the array bumps a
+//  generation counter in the shared header, and every other process
+//  remaps its view the next time it sees the counter change.
+//
+
+#ifndef __HHArray__HHSharedArray__
+#define __HHArray__HHSharedArray__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "HHArray.h"
+
+#ifndef _HHSHAREDARRAY_DEFINED_
+typedef struct { } *HHSharedArray;
+#endif
+
+/**
+ * Creates a shared array named `name` and attaches to it.
+ * @param name a POSIX shared memory name, such as "/collector". It must
+ *             not already exist.
+ * @param capacity the initial capacity, as in `hharray_create_capacity()`.
+ * @return the attached array, or NULL if the shared memory can't be created.
+ * @note if the shared memory can't be created, this function prints an error and exits.
+ * @note `O(capacity)`, to zero the initial slots.
+ */
+HHSharedArray hharray_create_shared(const char *name, size_t capacity);
+
+/**
+ * Attaches to the shared array another process created as `name`.
+ * @return the attached array, or NULL if there is no such shared array.
+ * @note if the array can't be attached, this function prints an error and exits.
+ * @note `O(1)`
+ */
+HHSharedArray hharray_attach_shared(const char *name);
+
+/**
+ * Unmaps the array from this process and frees the handle.
+ * The shared memory itself lives on until `hharray_shared_unlink()`.
+ * @note `O(1)`
+ */
+void hharray_shared_detach(HHSharedArray array);
+
+/**
+ * Removes the name of a shared array. Processes already attached keep
+ * their mappings; the memory is freed once the last one detaches.
+ * @note `O(1)`
+ */
+void hharray_shared_unlink(const char *name);
+
+/**
+ * @return the number of values appended so far.
+ * @note `O(1)`
+ */
+size_t hharray_shared_size(HHSharedArray array);
+
+/**
+ * @return the value at `index`.
+ * @note if `index` is out of bounds, this function prints an error and exits.
+ * @note `O(1)`, plus a remap if another process has grown the array.
+ */
+uint64_t hharray_shared_get(HHSharedArray array, size_t index);
+
+/**
+ * Replaces the value at `index`.
+ * @note if `index` is out of bounds, this function prints an error and exits.
+ * @note `O(1)`, plus a remap if another process has grown the array.
+ */
+void hharray_shared_set(HHSharedArray array, size_t index, uint64_t value);
+
+/**
+ * @return this process's view of the array's values, valid for indices
+ *         below `hharray_shared_size()` until the array next grows.
+ * @note `O(1)`, plus a remap if another process has grown the array.
+ */
+uint64_t *hharray_shared_values(HHSharedArray array);
+
+/**
+ * Appends the `value` at the end of the array, growing it if needed.
+ * Appends from all attached processes are serialized by a process-shared lock.
+ * @note amortized `O(1)`
+ */
+void hharray_shared_append(HHSharedArray array, uint64_t value);
+
+/**
+ * Appends `count` values at the end of the array under a single lock.
+ * @note `O(count)`
+ */
+void hharray_shared_append_values(HHSharedArray array, const uint64_t *values, size_t count);
+
+/**
+ * Copies the array into a new HHArray whose slots hold the integers.
+ * @note `O(n)`
+ */
+HHArray hharray_shared_to_array(HHSharedArray array);
+
+/**
+ * The append/consume protocol: appended values form a queue that a single
+ * consumer process reads in order. The consumer's position is stored in
+ * the shared header, so it survives the consumer reattaching.
+ * Consuming does not remove values from the array.
+ */
+
+/**
+ * Consumes the next value without blocking.
+ * @return `HHArrayStatusOK`, or `HHArrayStatusEmpty` if every appended
+ *         value has been consumed.
+ * @note Only one process may consume from an array.
+ * @note `O(1)`
+ */
+HHArrayStatus hharray_shared_try_consume(HHSharedArray array, uint64_t *value);
+
+/**
+ * Consumes the next value, waiting for one to be appended if needed.
+ * @return `HHArrayStatusOK`, or `HHArrayStatusEmpty` once the array is
+ *         closed and every value has been consumed.
+ * @note Only one process may consume from an array.
+ */
+HHArrayStatus hharray_shared_consume(HHSharedArray array, uint64_t *value);
+
+/**
+ * Marks the array as complete, waking a consumer waiting in
+ * `hharray_shared_consume()` once it has consumed everything.
+ * @note `O(1)`
+ */
+void hharray_shared_close(HHSharedArray array);
+
+#endif /* defined(__HHArray__HHSharedArray__) */
@@ -6,33 +6,19 @@
 //  Copyright (c) 2015 harlanhaskins. All rights reserved.
 //
 
-#include <stdlib.h>
-#include <stdint.h>
-#include <string.h>
-#include "utilities.h"
+#include <pthread.h>
+#include "HHArrayPrivate.h"
 
-#define ITEM_SIZE sizeof(void *)
-
-typedef struct HHArray_S {
-    size_t size;
-    size_t capacity;
-    void **values;
-} * HHArray;
-
-#define _HHARRAY_DEFINED_
-#include "HHArray.h"
-#undef _HHARRAY_DEFINED_
-
-const size_t DEFAULT_CAPACITY = 10;
+const size_t DEFAULT_CAPACITY = HHARRAY_DEFAULT_CAPACITY;
 const size_t HHArrayNotFound = SIZE_MAX;
-const double RESIZE_FACTOR = 1.5;
-const double LOAD_THRESHOLD = 0.75;
+const double RESIZE_FACTOR = HHARRAY_RESIZE_FACTOR;
+const double LOAD_THRESHOLD = HHARRAY_LOAD_THRESHOLD;
+static const size_t PARALLEL_SHUFFLE_THRESHOLD = 1 << 16;
+static const size_t PREFETCH_DISTANCE = 16;
 
-#ifdef UNIT_TEST
-#define EXIT_WITH_FAILURE exit(EXIT_FAILURE)
-#else
-#define EXIT_WITH_FAILURE
-#endif
+// Values handed to batch callbacks at a time: 8KB of input, so input,
+// output and mask all stay in L1.
+#define BATCH_SIZE 1024
 
 size_t min(size_t a, size_t b) {
     return a > b ? b : a;
@@ -42,14 +28,26 @@ size_t max(size_t a, size_t b) {
     return a > b ? a : b;
 }
 
-/**
- * Asserts that 'index' is less than 'highest', and otherwise causes an error and exits.
- */
-static void assert_index(HHArray array, size_t highest, size_t index) {
-    if (index > highest) {
-        fprintf(stderr, "Array index %zu higher than highest index %zu.", index, highest);
-        EXIT_WITH_FAILURE;
+void hharray_index_error(size_t count, size_t index) {
+    fprintf(stderr, "Array index %zu out of bounds for size %zu.", index, count);
+    EXIT_WITH_FAILURE;
+}
+
+void hharray_run_parallel(void *tasks, size_t task_size, size_t count, void *(*work)(void *)) {
+    char *task_bytes = tasks;
+    pthread_t *threads = hhcalloc(count, sizeof(pthread_t));
+    int *started = hhcalloc(count, sizeof(int));
+    for (size_t i = 1; i < count; i++) {
+        void *task = task_bytes + i * task_size;
+        started[i] = pthread_create(&threads[i], NULL, work, task) == 0;
+        if (!started[i]) work(task);
+    }
+    if (count > 0) work(tasks);
+    for (size_t i = 1; i < count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
     }
+    free(started);
+    free(threads);
 }
 
 #pragma mark - Creation and Destruction
@@ -112,17 +110,14 @@ void hharray_print(HHArray array) {
  * Determines whether shrinking the HHArray will keep it within the LOAD_THRESHOLD.
  */
 static int hharray_should_shrink(HHArray array) {
-    size_t capacity_after_shrink = array->capacity / RESIZE_FACTOR;
-    double load_after_shrink = (double)array->size / (double)capacity_after_shrink;
-    int should_shrink = load_after_shrink < LOAD_THRESHOLD && capacity_after_shrink > 0;
-    return should_shrink;
+    return hharray_policy_should_shrink(array->size, array->capacity);
 }
 
 /**
  * Shrinks an HHArray by RESIZE_FACTOR.
  */
 static void hharray_shrink(HHArray array) {
-    size_t new_capacity = array->capacity / RESIZE_FACTOR;
+    size_t new_capacity = hharray_policy_shrunk_capacity(array->capacity);
     array->values = hhrealloc(array->values, new_capacity * ITEM_SIZE);
     array->capacity = new_capacity;
 }
@@ -131,7 +126,7 @@ static void hharray_shrink(HHArray array) {
  * Determines whether the HHArray is past the LOAD_THRESHOLD.
  */
 static int hharray_should_grow(HHArray array) {
-    return ((double)array->size / (double)array->capacity) > LOAD_THRESHOLD;
+    return hharray_policy_should_grow(array->size, array->capacity);
 }
 
 void hharray_ensure_capacity(HHArray array, size_t capacity) {
@@ -144,13 +139,17 @@ void hharray_ensure_capacity(HHArray array, size_t capacity) {
  * Grows an HHArray by RESIZE_FACTOR.
  */
 static void hharray_grow(HHArray array) {
-    hharray_ensure_capacity(array, array->capacity * RESIZE_FACTOR);
+    hharray_ensure_capacity(array, hharray_policy_grown_capacity(array->capacity));
 }
 
 size_t hharray_size(HHArray array) {
     return array->size;
 }
 
+size_t hharray_capacity(HHArray array) {
+    return array->capacity;
+}
+
 #pragma mark - Insertion and Removal
 
 void hharray_append(HHArray array, void *value) {
@@ -162,31 +161,52 @@ void hharray_append(HHArray array, void *value) {
 }
 
 void *hharray_get(HHArray array, size_t index) {
-    assert_index(array, array->size - 1, index);
+    if (!check_index(array->size, index)) return NULL;
     return array->values[index];
 }
 
+void hharray_splice(HHArray dest, size_t index, size_t remove_count,
+                    HHArray source, size_t source_start, size_t source_count, HHArray *removed) {
+    if (!check_index(dest->size + 1, index) || !check_index(dest->size - index + 1, remove_count)) return;
+    if (source_count > 0 && (!check_index(source->size + 1, source_start) ||
+                             !check_index(source->size - source_start + 1, source_count))) return;
+    void **inserted = source_count > 0 ? &source->values[source_start] : NULL;
+    void **copy = NULL;
+    if (source == dest && source_count > 0) {
+        // The source range may overlap the region being moved, so take it first.
+        copy = hhcalloc(source_count, ITEM_SIZE);
+        memcpy(copy, inserted, source_count * ITEM_SIZE);
+        inserted = copy;
+    }
+    if (removed) {
+        *removed = hharray_create_capacity(max(remove_count / LOAD_THRESHOLD, 1));
+        memcpy((*removed)->values, &dest->values[index], remove_count * ITEM_SIZE);
+        (*removed)->size = remove_count;
+    }
+    size_t new_size = dest->size - remove_count + source_count;
+    if (new_size > dest->capacity) {
+        // Grow geometrically, so repeated small inserts stay amortized O(1).
+        hharray_ensure_capacity(dest, max(hharray_policy_grown_capacity(dest->capacity), new_size));
+    }
+    size_t tail = index + remove_count;
+    memmove(&dest->values[index + source_count], &dest->values[tail], (dest->size - tail) * ITEM_SIZE);
+    if (source_count > 0) {
+        memcpy(&dest->values[index], inserted, source_count * ITEM_SIZE);
+    }
+    dest->size = new_size;
+    free(copy);
+}
+
 void hharray_insert_list(HHArray dest, HHArray source, size_t index) {
-    assert_index(dest, dest->size - 1, index);
-    hharray_ensure_capacity(dest, dest->capacity + source->capacity);
-    void *old_value_dst = &dest->values[index + source->size];
-    void *input_index = &dest->values[index];
-    void *new_values = source->values;
-    memmove(old_value_dst, input_index, (source->size * ITEM_SIZE));
-    memcpy(input_index, new_values, (source->size * ITEM_SIZE));
-    dest->size += source->size;
+    hharray_splice(dest, index, 0, source, 0, source->size, NULL);
 }
 
 void hharray_append_list(HHArray dest, HHArray source) {
-    hharray_ensure_capacity(dest, dest->capacity + source->capacity);
-    void *dst = &dest->values[dest->size];
-    void *src = source->values;
-    memcpy(dst, src, (source->size * ITEM_SIZE));
-    dest->size += source->size;
+    hharray_splice(dest, dest->size, 0, source, 0, source->size, NULL);
 }
 
 void hharray_insert_index(HHArray array, void *value, size_t index) {
-    assert_index(array, array->size, index);
+    if (!check_index(array->size + 1, index)) return;
     if (hharray_should_grow(array)) {
         hharray_grow(array);
     }
@@ -198,7 +218,8 @@ void hharray_insert_index(HHArray array, void *value, size_t index) {
 }
 
 void *hharray_remove_index(HHArray array, size_t index) {
-    void *value = hharray_get(array, index);
+    if (!check_index(array->size, index)) return NULL;
+    void *value = array->values[index];
     array->values[index] = NULL;
     int is_last = (index == array->size - 1);
     array->size--;
@@ -212,6 +233,40 @@ void *hharray_remove_index(HHArray array, size_t index) {
     return value;
 }
 
+#pragma mark - Status Code Functions
+
+HHArrayStatus hharray_try_get(HHArray array, size_t index, void **value) {
+    if (index >= array->size) return HHArrayStatusIndexOutOfBounds;
+    *value = array->values[index];
+    return HHArrayStatusOK;
+}
+
+HHArrayStatus hharray_try_insert_index(HHArray array, void *value, size_t index) {
+    if (index > array->size) return HHArrayStatusIndexOutOfBounds;
+    hharray_insert_index(array, value, index);
+    return HHArrayStatusOK;
+}
+
+HHArrayStatus hharray_try_remove_index(HHArray array, size_t index, void **value) {
+    if (index >= array->size) return HHArrayStatusIndexOutOfBounds;
+    void *removed = hharray_remove_index(array, index);
+    if (value) *value = removed;
+    return HHArrayStatusOK;
+}
+
+HHArrayStatus hharray_try_swap(HHArray array, size_t first_index, size_t second_index) {
+    if (first_index >= array->size || second_index >= array->size) {
+        return HHArrayStatusIndexOutOfBounds;
+    }
+    _swap_values(array->values, first_index, second_index);
+    return HHArrayStatusOK;
+}
+
+HHArrayStatus hharray_try_pop(HHArray array, void **value) {
+    if (array->size == 0) return HHArrayStatusEmpty;
+    return hharray_try_remove_index(array, 0, value);
+}
+
 #pragma mark - Stack Functions
 
 void hharray_push(HHArray array, void *value) {
@@ -232,11 +287,159 @@ void *hharray_dequeue(HHArray array) {
     return hharray_pop(array);
 }
 
+#pragma mark - Random Numbers
+
+__extension__ typedef unsigned __int128 hh_uint128;
+
+static uint64_t _rotate_left(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * Advances a splitmix64 state, used to expand a seed into xoshiro state.
+ */
+static uint64_t _splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void hharray_random_seed(HHRandom *rng, uint64_t seed) {
+    for (size_t i = 0; i < 4; i++) {
+        rng->s[i] = _splitmix64(&seed);
+    }
+}
+
+uint64_t hharray_random_next(HHRandom *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = _rotate_left(s[0] + s[3], 23) + s[0];
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = _rotate_left(s[3], 45);
+    return result;
+}
+
+uint64_t hharray_random_bounded(HHRandom *rng, uint64_t bound) {
+    // Lemire's multiply-and-reject: one multiply in the common case.
+    hh_uint128 product = (hh_uint128)hharray_random_next(rng) * bound;
+    uint64_t low = (uint64_t)product;
+    if (low < bound) {
+        uint64_t threshold = -bound % bound;
+        while (low < threshold) {
+            product = (hh_uint128)hharray_random_next(rng) * bound;
+            low = (uint64_t)product;
+        }
+    }
+    return (uint64_t)(product >> 64);
+}
+
+#pragma mark - Index Sets
+
+/**
+ * Open-addressed set of indices, used by `hharray_sample()`,
+ * `hharray_unique()` and `hharray_distinct_count()`.
+ * Empty slots hold `HHArrayNotFound`. When the set holds indices into a
+ * values buffer, `hashes` caches each member's hash so most probes
+ * don't call the equality function.
+ */
+typedef struct {
+    size_t *slots;
+    size_t *hashes;
+    size_t mask;
+    int shift;
+} HHIndexSet;
+
+/**
+ * Sizes the set for `count` members at no more than half load.
+ */
+static void _index_set_init(HHIndexSet *set, size_t count, int cache_hashes) {
+    size_t capacity = 16;
+    int bits = 4;
+    while (capacity < count * 2) {
+        capacity <<= 1;
+        bits++;
+    }
+    set->slots = hhcalloc(capacity, sizeof(size_t));
+    memset(set->slots, 0xff, capacity * sizeof(size_t));
+    set->hashes = cache_hashes ? hhcalloc(capacity, sizeof(size_t)) : NULL;
+    set->mask = capacity - 1;
+    set->shift = 64 - bits;
+}
+
+static void _index_set_destroy(HHIndexSet *set) {
+    free(set->slots);
+    free(set->hashes);
+}
+
+/**
+ * Spreads a hash over the set's slots using its high bits (Fibonacci hashing),
+ * so weak hashes like raw pointers or small integers still distribute well.
+ */
+static inline size_t _index_set_slot(HHIndexSet *set, size_t hash) {
+    return (size_t)(((uint64_t)hash * 0x9e3779b97f4a7c15ULL) >> set->shift);
+}
+
+/**
+ * Inserts `index` into the set.
+ * @return non-zero if `index` was not already in the set.
+ */
+static int _index_set_insert(HHIndexSet *set, size_t index) {
+    size_t slot = _index_set_slot(set, index);
+    while (set->slots[slot] != HHArrayNotFound) {
+        if (set->slots[slot] == index) return 0;
+        slot = (slot + 1) & set->mask;
+    }
+    set->slots[slot] = index;
+    return 1;
+}
+
+/**
+ * Inserts `index` into a set of indices into `values`, where two indices
+ * are the same member if their values are the same pointer.
+ * @return non-zero if no identical value was already in the set.
+ */
+static int _index_set_insert_identity(HHIndexSet *set, void **values, size_t index) {
+    void *value = values[index];
+    size_t slot = _index_set_slot(set, (size_t)(uintptr_t)value);
+    while (set->slots[slot] != HHArrayNotFound) {
+        if (values[set->slots[slot]] == value) return 0;
+        slot = (slot + 1) & set->mask;
+    }
+    set->slots[slot] = index;
+    return 1;
+}
+
+/**
+ * Inserts `index` into a set of indices into `values`, where two indices
+ * are the same member if `is_equal` says their values are equal.
+ * The set must have been created with cached hashes.
+ * @return non-zero if no equal value was already in the set.
+ */
+static int _index_set_insert_value(HHIndexSet *set, void **values, size_t index,
+                                   size_t (*hash)(void *), int (*is_equal)(void *, void *)) {
+    void *value = values[index];
+    size_t value_hash = hash(value);
+    size_t slot = _index_set_slot(set, value_hash);
+    while (set->slots[slot] != HHArrayNotFound) {
+        if (set->hashes[slot] == value_hash && is_equal(value, values[set->slots[slot]])) {
+            return 0;
+        }
+        slot = (slot + 1) & set->mask;
+    }
+    set->slots[slot] = index;
+    set->hashes[slot] = value_hash;
+    return 1;
+}
+
 #pragma mark - Utilities
 
 void hharray_swap(HHArray array, size_t first_index, size_t second_index) {
-    assert_index(array, array->size - 1, first_index);
-    assert_index(array, array->size - 1, second_index);
+    if (!check_index(array->size, first_index) || !check_index(array->size, second_index)) return;
     void *first = array->values[first_index];
     void *second = array->values[second_index];
     array->values[first_index] = second;
@@ -251,15 +454,213 @@ void hharray_shuffle(HHArray array) {
     }
     for (size_t i = array->size - 1; i > 0; --i) {
         size_t swap = rand() / (RAND_MAX / i + 1);
-        hharray_swap(array, swap, (int)i);
+        _swap_values(array->values, swap, i);
+    }
+}
+
+/**
+ * Fischer-Yates shuffles `values[start..end)`.
+ */
+static void _shuffle_range(void **values, size_t start, size_t end, HHRandom *rng) {
+    for (size_t i = end - 1; i > start; --i) {
+        size_t swap = start + hharray_random_bounded(rng, i - start + 1);
+        _swap_values(values, swap, i);
+    }
+}
+
+void hharray_shuffle_r(HHArray array, HHRandom *rng) {
+    if (array->size <= 1) return;
+    _shuffle_range(array->values, 0, array->size, rng);
+}
+
+/**
+ * One unit of work for `hharray_shuffle_parallel()`: either a block to
+ * shuffle (`start..end`), or two adjacent shuffled blocks to merge
+ * (`start..middle` and `middle..end`).
+ */
+typedef struct {
+    void **values;
+    size_t start;
+    size_t middle;
+    size_t end;
+    HHRandom rng;
+} HHShuffleTask;
+
+static void *_shuffle_task(void *arg) {
+    HHShuffleTask *task = arg;
+    if (task->end - task->start > 1) {
+        _shuffle_range(task->values, task->start, task->end, &task->rng);
+    }
+    return NULL;
+}
+
+/**
+ * Randomly interleaves two uniformly shuffled adjacent blocks so that
+ * the combined block is uniformly shuffled (Bacher et al., MergeShuffle).
+ */
+static void *_merge_shuffle_task(void *arg) {
+    HHShuffleTask *task = arg;
+    void **values = task->values;
+    size_t i = task->start;
+    size_t j = task->middle;
+    uint64_t bits = 0;
+    size_t bits_left = 0;
+    for (;; i++) {
+        if (bits_left == 0) {
+            bits = hharray_random_next(&task->rng);
+            bits_left = 64;
+        }
+        int take_second = bits & 1;
+        bits >>= 1;
+        bits_left--;
+        if (take_second) {
+            if (j == task->end) break;
+            _swap_values(values, i, j);
+            j++;
+        } else if (i == j) {
+            break;
+        }
+    }
+    for (; i < task->end; i++) {
+        size_t swap = task->start + hharray_random_bounded(&task->rng, i - task->start + 1);
+        _swap_values(values, swap, i);
+    }
+    return NULL;
+}
+
+void hharray_shuffle_parallel(HHArray array, HHRandom *rng, size_t threads) {
+    size_t blocks = 1;
+    while (blocks * 2 <= threads && array->size / (blocks * 2) >= PARALLEL_SHUFFLE_THRESHOLD) {
+        blocks *= 2;
+    }
+    if (blocks == 1) {
+        hharray_shuffle_r(array, rng);
+        return;
+    }
+    size_t block_size = array->size / blocks;
+    HHShuffleTask *tasks = hhcalloc(blocks, sizeof(HHShuffleTask));
+    for (size_t i = 0; i < blocks; i++) {
+        tasks[i].values = array->values;
+        tasks[i].start = i * block_size;
+        tasks[i].end = (i == blocks - 1) ? array->size : (i + 1) * block_size;
+        hharray_random_seed(&tasks[i].rng, hharray_random_next(rng));
+    }
+    hharray_run_parallel(tasks, sizeof(HHShuffleTask), blocks, _shuffle_task);
+    for (size_t width = 1; width < blocks; width *= 2) {
+        size_t merges = blocks / (width * 2);
+        for (size_t i = 0; i < merges; i++) {
+            size_t first = i * width * 2;
+            tasks[i].start = first * block_size;
+            tasks[i].middle = (first + width) * block_size;
+            tasks[i].end = (first + width * 2 == blocks) ? array->size : (first + width * 2) * block_size;
+            hharray_random_seed(&tasks[i].rng, hharray_random_next(rng));
+        }
+        hharray_run_parallel(tasks, sizeof(HHShuffleTask), merges, _merge_shuffle_task);
+    }
+    free(tasks);
+}
+
+HHArray hharray_sample(HHArray array, size_t k, HHRandom *rng) {
+    if (k > array->size) {
+        fprintf(stderr, "Cannot sample %zu elements from an array of size %zu.", k, array->size);
+        EXIT_WITH_FAILURE;
+        k = array->size;
+    }
+    HHArray new = hharray_create_capacity(max(k / LOAD_THRESHOLD, 1));
+    if (k == 0) return new;
+    HHIndexSet chosen;
+    _index_set_init(&chosen, k, 0);
+    for (size_t j = array->size - k; j < array->size; j++) {
+        size_t index = hharray_random_bounded(rng, j + 1);
+        if (!_index_set_insert(&chosen, index)) {
+            _index_set_insert(&chosen, j);
+            index = j;
+        }
+        new->values[new->size++] = array->values[index];
+    }
+    _index_set_destroy(&chosen);
+    hharray_shuffle_r(new, rng);
+    return new;
+}
+
+/**
+ * Reverses `values[start..end)` in place, four slots at a time from
+ * each end when AVX2 is available.
+ */
+static void _reverse_range(void **values, size_t start, size_t end) {
+#ifdef HHARRAY_AVX2
+    while (end - start >= 8) {
+        __m256i front = _mm256_loadu_si256((const __m256i *)&values[start]);
+        __m256i back = _mm256_loadu_si256((const __m256i *)&values[end - 4]);
+        front = _mm256_permute4x64_epi64(front, _MM_SHUFFLE(0, 1, 2, 3));
+        back = _mm256_permute4x64_epi64(back, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm256_storeu_si256((__m256i *)&values[start], back);
+        _mm256_storeu_si256((__m256i *)&values[end - 4], front);
+        start += 4;
+        end -= 4;
+    }
+#endif
+    while (end - start >= 2) {
+        _swap_values(values, start, end - 1);
+        start++;
+        end--;
     }
 }
 
 void hharray_reverse(HHArray array) {
     if (array->size <= 1) return;
-    for (size_t i = 0; i < array->size / 2; i++) {
-        hharray_swap(array, i, array->size - i - 1);
+    _reverse_range(array->values, 0, array->size);
+}
+
+void hharray_rotate(HHArray array, size_t k) {
+    if (array->size <= 1) return;
+    k %= array->size;
+    if (k == 0) return;
+    _reverse_range(array->values, 0, k);
+    _reverse_range(array->values, k, array->size);
+    _reverse_range(array->values, 0, array->size);
+}
+
+/**
+ * Copies `values[indices[i]]` into `dest[i]` for each of the `count` indices,
+ * prefetching the slots a few iterations ahead of the copy.
+ * @return 0 if any index is not below `size`, in which case `dest` is partially filled.
+ */
+static int _gather_values(void **dest, void **values, size_t size, const size_t *indices, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (i + PREFETCH_DISTANCE < count) {
+            __builtin_prefetch(&values[min(indices[i + PREFETCH_DISTANCE], size - 1)]);
+        }
+        size_t index = indices[i];
+        if (!check_index(size, index)) return 0;
+        dest[i] = values[index];
     }
+    return 1;
+}
+
+void hharray_permute(HHArray array, const size_t *permutation) {
+    if (array->size == 0) return;
+    void **permuted = hhcalloc(array->capacity, ITEM_SIZE);
+    if (!_gather_values(permuted, array->values, array->size, permutation, array->size)) {
+        free(permuted);
+        return;
+    }
+    free(array->values);
+    array->values = permuted;
+}
+
+HHArray hharray_gather(HHArray array, const size_t *indices, size_t count) {
+    HHArray new = hharray_create_capacity(max(count / LOAD_THRESHOLD, 1));
+    if (count == 0) return new;
+    if (array->size == 0) {
+        fputs("Cannot gather from an empty array.\n", stderr);
+        EXIT_WITH_FAILURE;
+        return new;
+    }
+    if (_gather_values(new->values, array->values, array->size, indices, count)) {
+        new->size = count;
+    }
+    return new;
 }
 
 void hharray_sort(HHArray array, int (*comparison)(const void *a, const void *b)) {
@@ -284,8 +685,9 @@ int equals(void *a, void *b) {
 void *hharray_remove_f(HHArray array, void *element, int (*comparison)(void *, void *)) {
     size_t index = hharray_find_f(array, element, comparison);
     if (index == HHArrayNotFound) {
-        fprintf(stderr, "Element <%p> not found in array <%p>", element, array);
+        fprintf(stderr, "Element <%p> not found in array <%p>", element, (void *)array);
         EXIT_WITH_FAILURE;
+        return NULL;
     }
     return hharray_remove_index(array, index);
 }
@@ -297,8 +699,7 @@ void *hharray_remove(HHArray array, void *element) {
 HHArray hharray_slice(HHArray array, size_t first, size_t second) {
     size_t start = min(first, second);
     size_t end = max(first, second);
-    assert_index(array, array->size - 1, start);
-    assert_index(array, array->size - 1, end);
+    if (!check_index(array->size + 1, end)) return hharray_create();
     size_t num_elements = (end - start);
     size_t new_capacity = max(num_elements / LOAD_THRESHOLD, 1);
     HHArray new = hharray_create_capacity(new_capacity);
@@ -326,10 +727,57 @@ size_t hharray_find(HHArray array, void *element) {
     return hharray_find_f(array, element, equals);
 }
 
+#pragma mark - Deduplication
+
+/**
+ * Checks that `hash` and `is_equal` are either both provided or both NULL.
+ */
+static int _valid_hash_functions(size_t (*hash)(void *), int (*is_equal)(void *, void *)) {
+    if ((hash == NULL) != (is_equal == NULL)) {
+        fputs("A hash function and an equality function must be provided together.\n", stderr);
+        EXIT_WITH_FAILURE;
+        return 0;
+    }
+    return 1;
+}
+
+void hharray_unique(HHArray array, size_t (*hash)(void *), int (*is_equal)(void *, void *)) {
+    if (array->size <= 1 || !_valid_hash_functions(hash, is_equal)) return;
+    void **values = array->values;
+    HHIndexSet seen;
+    _index_set_init(&seen, array->size, hash != NULL);
+    size_t kept = 0;
+    for (size_t i = 0; i < array->size; i++) {
+        // Move first, then insert the new position; indices below `kept` never move again.
+        values[kept] = values[i];
+        int is_new = hash ? _index_set_insert_value(&seen, values, kept, hash, is_equal)
+                          : _index_set_insert_identity(&seen, values, kept);
+        if (is_new) kept++;
+    }
+    _index_set_destroy(&seen);
+    array->size = kept;
+    if (hharray_should_shrink(array)) {
+        hharray_shrink(array);
+    }
+}
+
+size_t hharray_distinct_count(HHArray array, size_t (*hash)(void *), int (*is_equal)(void *, void *)) {
+    if (array->size <= 1 || !_valid_hash_functions(hash, is_equal)) return array->size;
+    HHIndexSet seen;
+    _index_set_init(&seen, array->size, hash != NULL);
+    size_t count = 0;
+    for (size_t i = 0; i < array->size; i++) {
+        count += hash ? _index_set_insert_value(&seen, array->values, i, hash, is_equal)
+                      : _index_set_insert_identity(&seen, array->values, i);
+    }
+    _index_set_destroy(&seen);
+    return count;
+}
+
 #pragma mark - Functional Abstractions
 
 HHArray hharray_map(HHArray array, void *(*transform)(void *)) {
-    HHArray new = hharray_create_capacity(array->size);
+    HHArray new = hharray_create_capacity(max(array->size / LOAD_THRESHOLD, 1));
     for (size_t i = 0; i < array->size; i++) {
         void *new_value = transform(array->values[i]);
         hharray_append(new, new_value);
@@ -338,7 +786,7 @@ HHArray hharray_map(HHArray array, void *(*transform)(void *)) {
 }
 
 HHArray hharray_filter(HHArray array, int (*include)(void *)) {
-    HHArray new = hharray_create_capacity(array->size);
+    HHArray new = hharray_create_capacity(max(array->size / LOAD_THRESHOLD, 1));
     for (size_t i = 0; i < array->size; i++) {
         if (include(array->values[i])) {
             hharray_append(new, array->values[i]);
@@ -358,6 +806,50 @@ void *hharray_reduce(HHArray array, void *initial, void *(*combine)(void *, void
     return current;
 }
 
+HHArray hharray_map_batch(HHArray array, void (*transform)(void *const *in, void **out, size_t count, void *context),
+                          void *context) {
+    HHArray new = hharray_create_capacity(max(array->size / LOAD_THRESHOLD, 1));
+    for (size_t start = 0; start < array->size; start += BATCH_SIZE) {
+        size_t count = min(BATCH_SIZE, array->size - start);
+        transform(&array->values[start], &new->values[start], count, context);
+    }
+    new->size = array->size;
+    return new;
+}
+
+HHArray hharray_filter_batch(HHArray array, void (*include)(void *const *in, uint8_t *mask, size_t count, void *context),
+                             void *context) {
+    HHArray new = hharray_create_capacity(max(array->size / LOAD_THRESHOLD, 1));
+    uint8_t mask[BATCH_SIZE];
+    size_t kept = 0;
+    for (size_t start = 0; start < array->size; start += BATCH_SIZE) {
+        size_t count = min(BATCH_SIZE, array->size - start);
+        void **in = &array->values[start];
+        include(in, mask, count, context);
+        // Branchless compaction: always write, only advance past kept values.
+        for (size_t i = 0; i < count; i++) {
+            new->values[kept] = in[i];
+            kept += mask[i] != 0;
+        }
+    }
+    new->size = kept;
+    if (hharray_should_shrink(new)) {
+        hharray_shrink(new);
+    }
+    return new;
+}
+
+void *hharray_reduce_batch(HHArray array, void *initial,
+                           void *(*combine)(void *current, void *const *in, size_t count, void *context),
+                           void *context) {
+    void *current = initial;
+    for (size_t start = 0; start < array->size; start += BATCH_SIZE) {
+        size_t count = min(BATCH_SIZE, array->size - start);
+        current = combine(current, &array->values[start], count, context);
+    }
+    return current;
+}
+
 void **hharray_values(HHArray array) {
     void **new = hhcalloc(array->size, ITEM_SIZE);
     for (size_t i = 0; i < array->size; i++) {
@@ -0,0 +1,162 @@
+//
+//  HHArrayBuilder.c
+//  HHArray
+//
+
+#include "HHArrayPrivate.h"
+
+#define CACHE_LINE_SIZE 64
+
+static const size_t FIRST_CHUNK_CAPACITY = 256;
+static const size_t MAX_CHUNK_CAPACITY = 1 << 16;
+static const size_t PARALLEL_COPY_THRESHOLD = 1 << 16;
+
+/**
+ * A fixed-size block of a local buffer. Chunks are never resized; a full
+ * chunk is followed by a new one twice its size, up to MAX_CHUNK_CAPACITY.
+ */
+typedef struct HHBuilderChunk {
+    struct HHBuilderChunk *next;
+    size_t size;
+    size_t capacity;
+    void *values[];
+} HHBuilderChunk;
+
+/**
+ * One thread's buffer, aligned to a cache line so that threads appending
+ * next to each other don't contend for the same line.
+ */
+typedef struct __attribute__((aligned(CACHE_LINE_SIZE))) HHArrayBuilderLocal_S {
+    HHBuilderChunk *head;
+    HHBuilderChunk *tail;
+    size_t size;
+} * HHArrayBuilderLocal;
+
+typedef struct HHArrayBuilder_S {
+    size_t thread_count;
+    struct HHArrayBuilderLocal_S *locals;
+} * HHArrayBuilder;
+
+#define _HHARRAYBUILDER_DEFINED_
+#include "HHArrayBuilder.h"
+#undef _HHARRAYBUILDER_DEFINED_
+
+#pragma mark - Creation and Destruction
+
+HHArrayBuilder hharray_builder_create(size_t thread_count) {
+    if (thread_count == 0) {
+        fputs("Cannot create a builder for 0 threads.\n", stderr);
+        EXIT_WITH_FAILURE;
+        thread_count = 1;
+    }
+    HHArrayBuilder builder = hhmalloc(sizeof(struct HHArrayBuilder_S));
+    builder->thread_count = thread_count;
+    void *locals = NULL;
+    if (posix_memalign(&locals, CACHE_LINE_SIZE, thread_count * sizeof(struct HHArrayBuilderLocal_S)) != 0) {
+        perror("posix_memalign");
+        exit(EXIT_FAILURE);
+    }
+    memset(locals, 0, thread_count * sizeof(struct HHArrayBuilderLocal_S));
+    builder->locals = locals;
+    return builder;
+}
+
+void hharray_builder_destroy(HHArrayBuilder builder) {
+    for (size_t i = 0; i < builder->thread_count; i++) {
+        HHBuilderChunk *chunk = builder->locals[i].head;
+        while (chunk) {
+            HHBuilderChunk *next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+    }
+    free(builder->locals);
+    free(builder);
+}
+
+HHArrayBuilderLocal hharray_builder_local(HHArrayBuilder builder, size_t thread_index) {
+    if (!check_index(builder->thread_count, thread_index)) return NULL;
+    return &builder->locals[thread_index];
+}
+
+#pragma mark - Appending
+
+void hharray_builder_append(HHArrayBuilderLocal local, void *value) {
+    HHBuilderChunk *tail = local->tail;
+    if (tail == NULL || tail->size == tail->capacity) {
+        size_t capacity = tail ? min(tail->capacity * 2, MAX_CHUNK_CAPACITY) : FIRST_CHUNK_CAPACITY;
+        HHBuilderChunk *chunk = hhmalloc(sizeof(HHBuilderChunk) + capacity * ITEM_SIZE);
+        chunk->capacity = capacity;
+        if (tail) {
+            tail->next = chunk;
+        } else {
+            local->head = chunk;
+        }
+        local->tail = tail = chunk;
+    }
+    tail->values[tail->size++] = value;
+    local->size++;
+}
+
+size_t hharray_builder_local_size(HHArrayBuilderLocal local) {
+    return local->size;
+}
+
+#pragma mark - Finishing
+
+/**
+ * One copy thread's share of the output: `values[start..end)`.
+ */
+typedef struct {
+    HHArrayBuilder builder;
+    void **values;
+    size_t start;
+    size_t end;
+} HHBuilderCopyTask;
+
+/**
+ * Walks every chunk in output order and copies the parts that overlap
+ * this task's share of the output.
+ */
+static void *_copy_task(void *arg) {
+    HHBuilderCopyTask *task = arg;
+    size_t position = 0;
+    for (size_t i = 0; i < task->builder->thread_count && position < task->end; i++) {
+        struct HHArrayBuilderLocal_S *local = &task->builder->locals[i];
+        if (position + local->size <= task->start) {
+            position += local->size;
+            continue;
+        }
+        for (HHBuilderChunk *chunk = local->head; chunk && position < task->end; chunk = chunk->next) {
+            size_t chunk_end = position + chunk->size;
+            if (chunk_end > task->start) {
+                size_t from = max(position, task->start);
+                size_t to = min(chunk_end, task->end);
+                memcpy(&task->values[from], &chunk->values[from - position], (to - from) * ITEM_SIZE);
+            }
+            position = chunk_end;
+        }
+    }
+    return NULL;
+}
+
+HHArray hharray_builder_finish(HHArrayBuilder builder, size_t threads) {
+    size_t total = 0;
+    for (size_t i = 0; i < builder->thread_count; i++) {
+        total += builder->locals[i].size;
+    }
+    HHArray array = hharray_create_capacity(max(total, 1));
+    size_t task_count = max(min(threads, total / PARALLEL_COPY_THRESHOLD), 1);
+    HHBuilderCopyTask *tasks = hhcalloc(task_count, sizeof(HHBuilderCopyTask));
+    for (size_t i = 0; i < task_count; i++) {
+        tasks[i].builder = builder;
+        tasks[i].values = array->values;
+        tasks[i].start = total * i / task_count;
+        tasks[i].end = total * (i + 1) / task_count;
+    }
+    hharray_run_parallel(tasks, sizeof(HHBuilderCopyTask), task_count, _copy_task);
+    free(tasks);
+    array->size = total;
+    hharray_builder_destroy(builder);
+    return array;
+}
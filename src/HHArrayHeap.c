@@ -0,0 +1,128 @@
+//
+//  HHArrayHeap.c
+//  HHArray
+//
+//  Priority queue functions. The heap is stored directly in the array's
+//  slots as a 4-ary min-heap: the children of index `i` are `4i + 1`
+//  through `4i + 4`. The children sit next to each other, so a sift down
+//  compares them from adjacent slots, and the heap is half as deep as a
+//  binary one.
+//
+
+#include "HHArrayPrivate.h"
+
+#define HEAP_ARITY 4
+
+/**
+ * Records that `value` now lives at `index`, if the caller asked to know.
+ */
+static inline void _heap_moved(void (*moved)(void *value, size_t index), void *value, size_t index) {
+    if (moved) moved(value, index);
+}
+
+/**
+ * Moves the value at `index` towards the root until its parent orders before it.
+ * @return the value's final index.
+ */
+static size_t _heap_sift_up(void **values, size_t index,
+                            int (*comparison)(const void *a, const void *b),
+                            void (*moved)(void *value, size_t index)) {
+    void *value = values[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / HEAP_ARITY;
+        if (comparison(&value, &values[parent]) >= 0) break;
+        values[index] = values[parent];
+        _heap_moved(moved, values[index], index);
+        index = parent;
+    }
+    values[index] = value;
+    _heap_moved(moved, value, index);
+    return index;
+}
+
+/**
+ * Moves the value at `index` away from the root until no child orders before it.
+ */
+static void _heap_sift_down(void **values, size_t size, size_t index,
+                            int (*comparison)(const void *a, const void *b),
+                            void (*moved)(void *value, size_t index)) {
+    void *value = values[index];
+    for (;;) {
+        size_t first_child = index * HEAP_ARITY + 1;
+        if (first_child >= size) break;
+        size_t last_child = min(first_child + HEAP_ARITY, size);
+        size_t smallest = first_child;
+        for (size_t child = first_child + 1; child < last_child; child++) {
+            if (comparison(&values[child], &values[smallest]) < 0) smallest = child;
+        }
+        if (comparison(&values[smallest], &value) >= 0) break;
+        values[index] = values[smallest];
+        _heap_moved(moved, values[index], index);
+        index = smallest;
+    }
+    values[index] = value;
+    _heap_moved(moved, value, index);
+}
+
+void hharray_heapify(HHArray array, int (*comparison)(const void *a, const void *b),
+                     void (*moved)(void *value, size_t index)) {
+    if (array->size <= 1) return;
+    for (size_t i = (array->size - 2) / HEAP_ARITY + 1; i-- > 0;) {
+        _heap_sift_down(array->values, array->size, i, comparison, moved);
+    }
+}
+
+void hharray_heap_push(HHArray array, void *value, int (*comparison)(const void *a, const void *b),
+                       void (*moved)(void *value, size_t index)) {
+    hharray_append(array, value);
+    _heap_sift_up(array->values, array->size - 1, comparison, moved);
+}
+
+void *hharray_heap_peek(HHArray array) {
+    if (array->size == 0) {
+        fputs("Cannot peek at an empty heap.\n", stderr);
+        EXIT_WITH_FAILURE;
+        return NULL;
+    }
+    return array->values[0];
+}
+
+void *hharray_heap_pop(HHArray array, int (*comparison)(const void *a, const void *b),
+                       void (*moved)(void *value, size_t index)) {
+    if (array->size == 0) {
+        fputs("Cannot pop from an empty heap.\n", stderr);
+        EXIT_WITH_FAILURE;
+        return NULL;
+    }
+    void *top = array->values[0];
+    array->size--;
+    if (array->size > 0) {
+        array->values[0] = array->values[array->size];
+        _heap_sift_down(array->values, array->size, 0, comparison, moved);
+    }
+    array->values[array->size] = NULL;
+    return top;
+}
+
+void *hharray_heap_replace(HHArray array, void *value, int (*comparison)(const void *a, const void *b),
+                           void (*moved)(void *value, size_t index)) {
+    if (array->size == 0) {
+        fputs("Cannot replace the top of an empty heap.\n", stderr);
+        EXIT_WITH_FAILURE;
+        return NULL;
+    }
+    void *top = array->values[0];
+    array->values[0] = value;
+    _heap_sift_down(array->values, array->size, 0, comparison, moved);
+    return top;
+}
+
+void hharray_heap_decrease_key(HHArray array, size_t index, void *value,
+                               int (*comparison)(const void *a, const void *b),
+                               void (*moved)(void *value, size_t index)) {
+    if (!check_index(array->size, index)) return;
+    array->values[index] = value;
+    if (_heap_sift_up(array->values, index, comparison, moved) == index) {
+        _heap_sift_down(array->values, array->size, index, comparison, moved);
+    }
+}
@@ -0,0 +1,189 @@
+//
+//  HHArrayInt.c
+//  HHArray
+//
+//  Integer aggregates over HHArray slots. Each kernel has an AVX2 loop
+//  over the raw `values` buffer followed by a scalar loop that handles
+//  the tail, and the whole array when AVX2 isn't available. The histogram
+//  only vectorizes its bucket indices, and only for power-of-two widths.
+//
+
+#include "HHArrayPrivate.h"
+#include "HHArrayInt.h"
+
+/**
+ * Reads a slot as the integer it was stored as.
+ */
+static inline int64_t _slot_i64(void *value) {
+    return (int64_t)(intptr_t)value;
+}
+
+#ifdef HHARRAY_AVX2
+
+static inline __m256i _load4(void **values, size_t index) {
+    return _mm256_loadu_si256((const __m256i *)&values[index]);
+}
+
+static inline uint64_t _lane_sum(__m256i v) {
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+#endif
+
+int64_t hharray_i64_sum(HHArray array) {
+    void **values = array->values;
+    size_t size = array->size;
+    size_t i = 0;
+    uint64_t sum = 0;
+#ifdef HHARRAY_AVX2
+    __m256i first = _mm256_setzero_si256();
+    __m256i second = _mm256_setzero_si256();
+    for (; i + 8 <= size; i += 8) {
+        first = _mm256_add_epi64(first, _load4(values, i));
+        second = _mm256_add_epi64(second, _load4(values, i + 4));
+    }
+    sum = _lane_sum(_mm256_add_epi64(first, second));
+#endif
+    for (; i < size; i++) {
+        sum += (uint64_t)_slot_i64(values[i]);
+    }
+    return (int64_t)sum;
+}
+
+void hharray_i64_minmax(HHArray array, int64_t *min_out, int64_t *max_out) {
+    void **values = array->values;
+    size_t size = array->size;
+    size_t i = 0;
+    int64_t lowest = INT64_MAX;
+    int64_t highest = INT64_MIN;
+#ifdef HHARRAY_AVX2
+    // AVX2 has no 64-bit min/max, so compare and blend instead.
+    __m256i low = _mm256_set1_epi64x(INT64_MAX);
+    __m256i high = _mm256_set1_epi64x(INT64_MIN);
+    for (; i + 4 <= size; i += 4) {
+        __m256i v = _load4(values, i);
+        low = _mm256_blendv_epi8(low, v, _mm256_cmpgt_epi64(low, v));
+        high = _mm256_blendv_epi8(high, v, _mm256_cmpgt_epi64(v, high));
+    }
+    int64_t low_lanes[4], high_lanes[4];
+    _mm256_storeu_si256((__m256i *)low_lanes, low);
+    _mm256_storeu_si256((__m256i *)high_lanes, high);
+    for (size_t lane = 0; lane < 4; lane++) {
+        if (low_lanes[lane] < lowest) lowest = low_lanes[lane];
+        if (high_lanes[lane] > highest) highest = high_lanes[lane];
+    }
+#endif
+    for (; i < size; i++) {
+        int64_t value = _slot_i64(values[i]);
+        if (value < lowest) lowest = value;
+        if (value > highest) highest = value;
+    }
+    if (min_out) *min_out = lowest;
+    if (max_out) *max_out = highest;
+}
+
+int64_t hharray_i64_min(HHArray array) {
+    int64_t lowest;
+    hharray_i64_minmax(array, &lowest, NULL);
+    return lowest;
+}
+
+int64_t hharray_i64_max(HHArray array) {
+    int64_t highest;
+    hharray_i64_minmax(array, NULL, &highest);
+    return highest;
+}
+
+size_t hharray_i64_count_if_range(HHArray array, int64_t low, int64_t high) {
+    void **values = array->values;
+    size_t size = array->size;
+    size_t i = 0;
+    size_t count = 0;
+#ifdef HHARRAY_AVX2
+    __m256i low_v = _mm256_set1_epi64x(low);
+    __m256i high_v = _mm256_set1_epi64x(high);
+    __m256i counts = _mm256_setzero_si256();
+    for (; i + 4 <= size; i += 4) {
+        __m256i v = _load4(values, i);
+        // Matching lanes are all ones (-1), so subtracting counts them.
+        __m256i in_range = _mm256_andnot_si256(_mm256_cmpgt_epi64(low_v, v),
+                                               _mm256_cmpgt_epi64(high_v, v));
+        counts = _mm256_sub_epi64(counts, in_range);
+    }
+    count = _lane_sum(counts);
+#endif
+    for (; i < size; i++) {
+        int64_t value = _slot_i64(values[i]);
+        count += (value >= low) & (value < high);
+    }
+    return count;
+}
+
+void hharray_i64_histogram(HHArray array, int64_t low, uint64_t bucket_width,
+                           size_t *buckets, size_t bucket_count) {
+    if (bucket_width == 0) {
+        fputs("Cannot build a histogram with a bucket width of 0.\n", stderr);
+        EXIT_WITH_FAILURE;
+        return;
+    }
+    // Power-of-two widths avoid a 64-bit division per element.
+    int shift = (bucket_width & (bucket_width - 1)) == 0 ? __builtin_ctzll(bucket_width) : -1;
+    void **values = array->values;
+    size_t size = array->size;
+    size_t i = 0;
+#ifdef HHARRAY_AVX2
+    if (shift >= 0) {
+        // The increments are scattered writes, so only the bucket indices are
+        // computed four at a time. Lanes below `low` become UINT64_MAX, which
+        // is never a bucket.
+        __m256i low_v = _mm256_set1_epi64x(low);
+        __m128i shift_v = _mm_cvtsi32_si128(shift);
+        uint64_t lanes[4];
+        for (; i + 4 <= size; i += 4) {
+            __m256i v = _load4(values, i);
+            __m256i below = _mm256_cmpgt_epi64(low_v, v);
+            __m256i bucket = _mm256_srl_epi64(_mm256_sub_epi64(v, low_v), shift_v);
+            _mm256_storeu_si256((__m256i *)lanes, _mm256_or_si256(bucket, below));
+            for (size_t lane = 0; lane < 4; lane++) {
+                if (lanes[lane] < bucket_count) buckets[lanes[lane]]++;
+            }
+        }
+    }
+#endif
+    for (; i < size; i++) {
+        int64_t value = _slot_i64(values[i]);
+        if (value < low) continue;
+        uint64_t offset = (uint64_t)value - (uint64_t)low;
+        uint64_t bucket = shift >= 0 ? offset >> shift : offset / bucket_width;
+        if (bucket < bucket_count) {
+            buckets[bucket]++;
+        }
+    }
+}
+
+void hharray_i64_prefix_sum(HHArray array) {
+    void **values = array->values;
+    size_t size = array->size;
+    size_t i = 0;
+#ifdef HHARRAY_AVX2
+    __m256i zero = _mm256_setzero_si256();
+    __m256i carry = zero;
+    for (; i + 4 <= size; i += 4) {
+        __m256i v = _load4(values, i);
+        // [a, b, c, d] -> [a, a+b, c, c+d] -> [a, a+b, a+b+c, a+b+c+d]
+        v = _mm256_add_epi64(v, _mm256_slli_si256(v, 8));
+        __m256i low_half = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 1, 1, 1));
+        v = _mm256_add_epi64(v, _mm256_blend_epi32(zero, low_half, 0xF0));
+        v = _mm256_add_epi64(v, carry);
+        _mm256_storeu_si256((__m256i *)&values[i], v);
+        carry = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+#endif
+    uint64_t running = i > 0 ? (uint64_t)_slot_i64(values[i - 1]) : 0;
+    for (; i < size; i++) {
+        running += (uint64_t)_slot_i64(values[i]);
+        values[i] = (void *)(intptr_t)(int64_t)running;
+    }
+}
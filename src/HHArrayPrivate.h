@@ -0,0 +1,93 @@
+//
+//  HHArrayPrivate.h
+//  HHArray
+//
+//  Internal layout of HHArray, shared by the library's source files.
+//  Not installed; clients only ever see the opaque type in HHArray.h.
+//
+
+#ifndef __HHArray__HHArrayPrivate__
+#define __HHArray__HHArrayPrivate__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "utilities.h"
+#include "HHArrayPolicy.h"
+
+#define ITEM_SIZE sizeof(void *)
+
+// Vector kernels treat slots as 64-bit lanes, so they need 64-bit pointers.
+#if defined(__AVX2__) && UINTPTR_MAX == UINT64_MAX
+#include <immintrin.h>
+#define HHARRAY_AVX2 1
+#endif
+
+typedef struct HHArray_S {
+    size_t size;
+    size_t capacity;
+    void **values;
+} * HHArray;
+
+#define _HHARRAY_DEFINED_
+#include "HHArray.h"
+#undef _HHARRAY_DEFINED_
+
+extern const size_t DEFAULT_CAPACITY;
+extern const double RESIZE_FACTOR;
+extern const double LOAD_THRESHOLD;
+
+// HHARRAY_CHECKED makes every misuse fatal. Otherwise errors are reported
+// and the offending call returns without touching memory it doesn't own.
+#define EXIT_WITH_FAILURE HHARRAY_EXIT_WITH_FAILURE
+
+size_t min(size_t a, size_t b);
+
+size_t max(size_t a, size_t b);
+
+/**
+ * Prints an out-of-bounds error and exits. Kept out of line so that
+ * `check_index()` stays small enough to inline into every accessor.
+ */
+void hharray_index_error(size_t count, size_t index) __attribute__((cold, noinline));
+
+/**
+ * Checks that `index` is less than `count`, and otherwise causes an error and exits.
+ * @return non-zero if `index` is valid. Always non-zero when built with
+ *         HHARRAY_UNCHECKED, which compiles the check out entirely.
+ */
+static inline int check_index(size_t count, size_t index) {
+#ifdef HHARRAY_UNCHECKED
+    (void)count;
+    (void)index;
+    return 1;
+#else
+    if (__builtin_expect(index < count, 1)) return 1;
+    hharray_index_error(count, index);
+    return 0;
+#endif
+}
+
+/**
+ * Grows the array's storage to hold at least `capacity` slots.
+ */
+void hharray_ensure_capacity(HHArray array, size_t capacity);
+
+/**
+ * Runs `work` on each of `count` tasks of `task_size` bytes, one thread per
+ * task, with the first task on the calling thread. Returns once all are done.
+ * If a thread can't be started, its task runs on the calling thread instead.
+ */
+void hharray_run_parallel(void *tasks, size_t task_size, size_t count, void *(*work)(void *));
+
+/**
+ * Swaps two slots without bounds checks, for internal loops that
+ * have already validated their ranges.
+ */
+static inline void _swap_values(void **values, size_t a, size_t b) {
+    void *tmp = values[a];
+    values[a] = values[b];
+    values[b] = tmp;
+}
+
+#endif /* defined(__HHArray__HHArrayPrivate__) */
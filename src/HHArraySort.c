@@ -0,0 +1,515 @@
+//
+//  HHArraySort.c
+//  HHArray
+//
+//  Stable sorting and selection. All functions use the same comparator
+//  contract as `hharray_sort`: the comparator receives pointers to slots.
+//
+
+#include "HHArrayPrivate.h"
+
+static const size_t MIN_RUN = 32;
+static const size_t INSERTION_SORT_THRESHOLD = 16;
+
+#pragma mark - Stable Sort
+
+/**
+ * Sorts `values[start..end)` with binary insertion, given that
+ * `values[start..sorted_end)` is already sorted.
+ * Equal values are inserted after their equals, which keeps the sort stable.
+ */
+static void _binary_insertion_sort(void **values, size_t start, size_t sorted_end, size_t end,
+                                   int (*comparison)(const void *a, const void *b)) {
+    for (size_t i = sorted_end; i < end; i++) {
+        void *value = values[i];
+        size_t low = start;
+        size_t high = i;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (comparison(&value, &values[middle]) < 0) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+        }
+        memmove(&values[low + 1], &values[low], (i - low) * ITEM_SIZE);
+        values[low] = value;
+    }
+}
+
+/**
+ * Finds the end of the run starting at `start`. Strictly descending
+ * runs are reversed in place, so the returned run is always ascending.
+ */
+static size_t _find_run(void **values, size_t start, size_t end,
+                        int (*comparison)(const void *a, const void *b)) {
+    size_t i = start + 1;
+    if (i == end) return end;
+    if (comparison(&values[i], &values[start]) < 0) {
+        while (i + 1 < end && comparison(&values[i + 1], &values[i]) < 0) i++;
+        for (size_t low = start, high = i; low < high; low++, high--) {
+            _swap_values(values, low, high);
+        }
+    } else {
+        while (i + 1 < end && comparison(&values[i + 1], &values[i]) >= 0) i++;
+    }
+    return i + 1;
+}
+
+/**
+ * Stably merges the sorted runs `values[start..middle)` and `values[middle..end)`,
+ * copying the shorter run into `buffer`.
+ */
+static void _merge_runs(void **values, void **buffer, size_t start, size_t middle, size_t end,
+                        int (*comparison)(const void *a, const void *b)) {
+    if (comparison(&values[middle - 1], &values[middle]) <= 0) return;
+    size_t left_size = middle - start;
+    size_t right_size = end - middle;
+    if (left_size <= right_size) {
+        memcpy(buffer, &values[start], left_size * ITEM_SIZE);
+        size_t i = 0, j = middle, k = start;
+        while (i < left_size && j < end) {
+            if (comparison(&values[j], &buffer[i]) < 0) {
+                values[k++] = values[j++];
+            } else {
+                values[k++] = buffer[i++];
+            }
+        }
+        memcpy(&values[k], &buffer[i], (left_size - i) * ITEM_SIZE);
+    } else {
+        memcpy(buffer, &values[middle], right_size * ITEM_SIZE);
+        size_t i = right_size, j = middle, k = end;
+        while (i > 0 && j > start) {
+            if (comparison(&buffer[i - 1], &values[j - 1]) < 0) {
+                values[--k] = values[--j];
+            } else {
+                values[--k] = buffer[--i];
+            }
+        }
+        memcpy(&values[start], buffer, i * ITEM_SIZE);
+    }
+}
+
+void hharray_sort_stable(HHArray array, int (*comparison)(const void *a, const void *b)) {
+    size_t size = array->size;
+    if (size <= 1) return;
+    void **values = array->values;
+    size_t *bounds = hhcalloc(size / MIN_RUN + 2, sizeof(size_t));
+    size_t run_count = 0;
+    for (size_t start = 0; start < size;) {
+        size_t end = _find_run(values, start, size, comparison);
+        if (end - start < MIN_RUN) {
+            size_t forced_end = min(start + MIN_RUN, size);
+            _binary_insertion_sort(values, start, end, forced_end, comparison);
+            end = forced_end;
+        }
+        bounds[run_count++] = start;
+        start = end;
+    }
+    bounds[run_count] = size;
+    void **buffer = hhcalloc(size / 2 + 1, ITEM_SIZE);
+    while (run_count > 1) {
+        size_t merged = 0;
+        for (size_t i = 0; i < run_count; i += 2) {
+            if (i + 1 < run_count) {
+                _merge_runs(values, buffer, bounds[i], bounds[i + 1], bounds[i + 2], comparison);
+            }
+            bounds[merged++] = bounds[i];
+        }
+        bounds[merged] = size;
+        run_count = merged;
+    }
+    free(buffer);
+    free(bounds);
+}
+
+#pragma mark - Selection
+
+/**
+ * Restores the max-heap property of `values[start..start + count)`
+ * below `root`, an offset from `start`.
+ */
+static void _sift_down(void **values, size_t start, size_t count, size_t root,
+                       int (*comparison)(const void *a, const void *b)) {
+    void **heap = &values[start];
+    for (;;) {
+        size_t largest = root;
+        size_t left = 2 * root + 1;
+        size_t right = left + 1;
+        if (left < count && comparison(&heap[left], &heap[largest]) > 0) largest = left;
+        if (right < count && comparison(&heap[right], &heap[largest]) > 0) largest = right;
+        if (largest == root) return;
+        _swap_values(heap, root, largest);
+        root = largest;
+    }
+}
+
+/**
+ * Places the correct value at `nth` within `values[start..end)` by keeping
+ * a max-heap of the smallest values seen. Used when quickselect degrades.
+ * @note `O(n * log(n))`
+ */
+static void _heap_select(void **values, size_t start, size_t end, size_t nth,
+                         int (*comparison)(const void *a, const void *b)) {
+    size_t count = nth - start + 1;
+    for (size_t i = count / 2; i-- > 0;) {
+        _sift_down(values, start, count, i, comparison);
+    }
+    for (size_t i = nth + 1; i < end; i++) {
+        if (comparison(&values[i], &values[start]) < 0) {
+            _swap_values(values, start, i);
+            _sift_down(values, start, count, 0, comparison);
+        }
+    }
+    _swap_values(values, start, nth);
+}
+
+static void _insertion_sort(void **values, size_t start, size_t end,
+                            int (*comparison)(const void *a, const void *b)) {
+    for (size_t i = start + 1; i < end; i++) {
+        void *value = values[i];
+        size_t j = i;
+        while (j > start && comparison(&value, &values[j - 1]) < 0) {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = value;
+    }
+}
+
+/**
+ * Partitions `values[start..end)` around the median of its first, middle
+ * and last values.
+ * @return the pivot's final index. Values before it compare less than or
+ *         equal to it, and values after it compare greater than or equal.
+ */
+static size_t _partition(void **values, size_t start, size_t end,
+                         int (*comparison)(const void *a, const void *b)) {
+    size_t middle = start + (end - start) / 2;
+    size_t last = end - 1;
+    if (comparison(&values[middle], &values[start]) < 0) _swap_values(values, middle, start);
+    if (comparison(&values[last], &values[start]) < 0) _swap_values(values, last, start);
+    if (comparison(&values[last], &values[middle]) < 0) _swap_values(values, last, middle);
+    _swap_values(values, start, middle);
+    void *pivot = values[start];
+    size_t i = start;
+    size_t j = end;
+    for (;;) {
+        while (comparison(&values[++i], &pivot) < 0) {
+            if (i == last) break;
+        }
+        while (comparison(&pivot, &values[--j]) < 0) {
+            if (j == start) break;
+        }
+        if (i >= j) break;
+        _swap_values(values, i, j);
+    }
+    _swap_values(values, start, j);
+    return j;
+}
+
+/**
+ * Introselect: quickselect with median-of-three pivots, falling back to
+ * heap selection once the recursion depth exceeds `2 * log2(n)`.
+ */
+static void _select(void **values, size_t start, size_t end, size_t nth,
+                    int (*comparison)(const void *a, const void *b)) {
+    size_t depth_limit = 0;
+    for (size_t n = end - start; n > 1; n >>= 1) depth_limit += 2;
+    while (end - start > INSERTION_SORT_THRESHOLD) {
+        if (depth_limit-- == 0) {
+            _heap_select(values, start, end, nth, comparison);
+            return;
+        }
+        size_t pivot = _partition(values, start, end, comparison);
+        if (pivot == nth) return;
+        if (nth < pivot) {
+            end = pivot;
+        } else {
+            start = pivot + 1;
+        }
+    }
+    _insertion_sort(values, start, end, comparison);
+}
+
+void hharray_nth_element(HHArray array, size_t nth, int (*comparison)(const void *a, const void *b)) {
+    if (!check_index(array->size, nth) || array->size <= 1) return;
+    _select(array->values, 0, array->size, nth, comparison);
+}
+
+void hharray_partial_sort(HHArray array, size_t k, int (*comparison)(const void *a, const void *b)) {
+    if (k >= array->size) {
+        hharray_sort(array, comparison);
+        return;
+    }
+    if (k == 0) return;
+    _select(array->values, 0, array->size, k, comparison);
+    qsort(array->values, k, ITEM_SIZE, comparison);
+}
+
+#pragma mark - Top K
+
+/**
+ * A value paired with its original index, so ties can be broken by
+ * insertion order.
+ */
+typedef struct {
+    void *value;
+    size_t index;
+} HHRankedValue;
+
+static int _ranked_before(HHRankedValue *a, HHRankedValue *b,
+                          int (*comparison)(const void *a, const void *b)) {
+    int result = comparison(&a->value, &b->value);
+    return result < 0 || (result == 0 && a->index < b->index);
+}
+
+/**
+ * Restores the heap below `root`, where the root holds the value ranked last.
+ */
+static void _ranked_sift_down(HHRankedValue *heap, size_t count, size_t root,
+                              int (*comparison)(const void *a, const void *b)) {
+    for (;;) {
+        size_t last = root;
+        size_t left = 2 * root + 1;
+        size_t right = left + 1;
+        if (left < count && _ranked_before(&heap[last], &heap[left], comparison)) last = left;
+        if (right < count && _ranked_before(&heap[last], &heap[right], comparison)) last = right;
+        if (last == root) return;
+        HHRankedValue tmp = heap[root];
+        heap[root] = heap[last];
+        heap[last] = tmp;
+        root = last;
+    }
+}
+
+HHArray hharray_top_k(HHArray array, size_t k, int (*comparison)(const void *a, const void *b)) {
+    k = min(k, array->size);
+    HHArray new = hharray_create_capacity(max(k / LOAD_THRESHOLD, 1));
+    if (k == 0) return new;
+    HHRankedValue *heap = hhcalloc(k, sizeof(HHRankedValue));
+    for (size_t i = 0; i < k; i++) {
+        heap[i] = (HHRankedValue){array->values[i], i};
+    }
+    for (size_t i = k / 2; i-- > 0;) {
+        _ranked_sift_down(heap, k, i, comparison);
+    }
+    for (size_t i = k; i < array->size; i++) {
+        HHRankedValue candidate = {array->values[i], i};
+        if (_ranked_before(&candidate, &heap[0], comparison)) {
+            heap[0] = candidate;
+            _ranked_sift_down(heap, k, 0, comparison);
+        }
+    }
+    for (size_t count = k; count > 0; count--) {
+        new->values[count - 1] = heap[0].value;
+        heap[0] = heap[count - 1];
+        _ranked_sift_down(heap, count - 1, 0, comparison);
+    }
+    new->size = k;
+    free(heap);
+    return new;
+}
+
+#pragma mark - Sorted Merging
+
+static const size_t GALLOP_RATIO = 16;
+
+/**
+ * Creates the output array for a merge or set operation, with room for
+ * `count` values so the output is written without any further allocation.
+ */
+static HHArray _create_output(size_t count) {
+    return hharray_create_capacity(max(count, 1));
+}
+
+HHArray hharray_merge_sorted(HHArray a, HHArray b, int (*comparison)(const void *a, const void *b)) {
+    HHArray new = _create_output(a->size + b->size);
+    void **out = new->values;
+    size_t i = 0, j = 0, k = 0;
+    while (i < a->size && j < b->size) {
+        if (comparison(&b->values[j], &a->values[i]) < 0) {
+            out[k++] = b->values[j++];
+        } else {
+            out[k++] = a->values[i++];
+        }
+    }
+    memcpy(&out[k], &a->values[i], (a->size - i) * ITEM_SIZE);
+    k += a->size - i;
+    memcpy(&out[k], &b->values[j], (b->size - j) * ITEM_SIZE);
+    new->size = a->size + b->size;
+    return new;
+}
+
+/**
+ * @return non-zero if the next value of `arrays[first]` should be merged
+ *         before the next value of `arrays[second]`. Ties go to the earlier array.
+ */
+static int _cursor_before(HHArray *arrays, size_t *positions, size_t first, size_t second,
+                          int (*comparison)(const void *a, const void *b)) {
+    int result = comparison(&arrays[first]->values[positions[first]],
+                            &arrays[second]->values[positions[second]]);
+    return result < 0 || (result == 0 && first < second);
+}
+
+static void _cursor_sift_down(size_t *heap, size_t count, size_t root, HHArray *arrays, size_t *positions,
+                              int (*comparison)(const void *a, const void *b)) {
+    for (;;) {
+        size_t first = root;
+        size_t left = 2 * root + 1;
+        size_t right = left + 1;
+        if (left < count && _cursor_before(arrays, positions, heap[left], heap[first], comparison)) first = left;
+        if (right < count && _cursor_before(arrays, positions, heap[right], heap[first], comparison)) first = right;
+        if (first == root) return;
+        size_t tmp = heap[root];
+        heap[root] = heap[first];
+        heap[first] = tmp;
+        root = first;
+    }
+}
+
+HHArray hharray_merge_k(HHArray *arrays, size_t count, int (*comparison)(const void *a, const void *b)) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += arrays[i]->size;
+    }
+    HHArray new = _create_output(total);
+    if (total == 0) return new;
+    size_t *positions = hhcalloc(count, sizeof(size_t));
+    size_t *heap = hhcalloc(count, sizeof(size_t));
+    size_t heap_size = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (arrays[i]->size > 0) heap[heap_size++] = i;
+    }
+    for (size_t i = heap_size / 2; i-- > 0;) {
+        _cursor_sift_down(heap, heap_size, i, arrays, positions, comparison);
+    }
+    void **out = new->values;
+    size_t k = 0;
+    while (heap_size > 1) {
+        size_t source = heap[0];
+        out[k++] = arrays[source]->values[positions[source]++];
+        if (positions[source] == arrays[source]->size) {
+            heap[0] = heap[--heap_size];
+        }
+        _cursor_sift_down(heap, heap_size, 0, arrays, positions, comparison);
+    }
+    size_t last = heap[0];
+    memcpy(&out[k], &arrays[last]->values[positions[last]],
+           (arrays[last]->size - positions[last]) * ITEM_SIZE);
+    new->size = total;
+    free(heap);
+    free(positions);
+    return new;
+}
+
+#pragma mark - Sorted Set Operations
+
+/**
+ * Finds the first value in `values[start..end)` that is not less than `key`,
+ * probing at exponentially growing distances from `start` before
+ * binary searching. Cheap when the answer is close to `start`.
+ */
+static size_t _gallop_lower_bound(void **values, size_t start, size_t end, void *key,
+                                  int (*comparison)(const void *a, const void *b)) {
+    size_t low = start;
+    size_t high = start;
+    size_t step = 1;
+    while (high < end && comparison(&values[high], &key) < 0) {
+        low = high + 1;
+        high = start + step;
+        step *= 2;
+    }
+    high = min(high, end);
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (comparison(&values[middle], &key) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+HHArray hharray_union(HHArray a, HHArray b, int (*comparison)(const void *a, const void *b)) {
+    HHArray new = _create_output(a->size + b->size);
+    void **out = new->values;
+    size_t i = 0, j = 0, k = 0;
+    while (i < a->size && j < b->size) {
+        int result = comparison(&a->values[i], &b->values[j]);
+        if (result < 0) {
+            out[k++] = a->values[i++];
+        } else if (result > 0) {
+            out[k++] = b->values[j++];
+        } else {
+            out[k++] = a->values[i++];
+            j++;
+        }
+    }
+    memcpy(&out[k], &a->values[i], (a->size - i) * ITEM_SIZE);
+    k += a->size - i;
+    memcpy(&out[k], &b->values[j], (b->size - j) * ITEM_SIZE);
+    k += b->size - j;
+    new->size = k;
+    return new;
+}
+
+HHArray hharray_intersection(HHArray a, HHArray b, int (*comparison)(const void *a, const void *b)) {
+    HHArray new = _create_output(min(a->size, b->size));
+    void **out = new->values;
+    size_t i = 0, j = 0, k = 0;
+    if (a->size * GALLOP_RATIO <= b->size) {
+        for (; i < a->size; i++) {
+            j = _gallop_lower_bound(b->values, j, b->size, a->values[i], comparison);
+            if (j == b->size) break;
+            if (comparison(&b->values[j], &a->values[i]) == 0) {
+                out[k++] = a->values[i];
+                j++;
+            }
+        }
+    } else if (b->size * GALLOP_RATIO <= a->size) {
+        for (; j < b->size; j++) {
+            i = _gallop_lower_bound(a->values, i, a->size, b->values[j], comparison);
+            if (i == a->size) break;
+            if (comparison(&a->values[i], &b->values[j]) == 0) {
+                out[k++] = a->values[i++];
+            }
+        }
+    } else {
+        while (i < a->size && j < b->size) {
+            int result = comparison(&a->values[i], &b->values[j]);
+            if (result < 0) {
+                i++;
+            } else if (result > 0) {
+                j++;
+            } else {
+                out[k++] = a->values[i++];
+                j++;
+            }
+        }
+    }
+    new->size = k;
+    return new;
+}
+
+HHArray hharray_difference(HHArray a, HHArray b, int (*comparison)(const void *a, const void *b)) {
+    HHArray new = _create_output(a->size);
+    void **out = new->values;
+    size_t i = 0, j = 0, k = 0;
+    while (i < a->size && j < b->size) {
+        int result = comparison(&a->values[i], &b->values[j]);
+        if (result < 0) {
+            out[k++] = a->values[i++];
+        } else if (result > 0) {
+            j++;
+        } else {
+            i++;
+            j++;
+        }
+    }
+    memcpy(&out[k], &a->values[i], (a->size - i) * ITEM_SIZE);
+    k += a->size - i;
+    new->size = k;
+    return new;
+}
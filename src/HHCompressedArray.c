@@ -0,0 +1,283 @@
+//
+//  HHCompressedArray.c
+//  HHArray
+//
+//  Each block of BLOCK_SIZE values stores the gaps between neighbours,
+//  starting with a gap of 0 before the block's first value, which lives
+//  in the skip index. Gaps are bit-packed at the width of the block's
+//  largest gap in a vertical layout: gap `j` goes to lane `j % LANES` of
+//  row `j / LANES`, and each lane is its own stream of 32-bit words, so a
+//  whole row unpacks with one shift and mask across LANES values at once.
+//  Blocks with a gap wider than 32 bits store their gaps raw.
+//
+
+#include <stdio.h>
+#include "HHArrayPrivate.h"
+
+#define BLOCK_SHIFT 7
+#define BLOCK_SIZE ((size_t)1 << BLOCK_SHIFT)
+#define LANES 8
+#define ROWS (BLOCK_SIZE / LANES)
+#define RAW_WIDTH 64
+
+typedef struct HHCompressedArray_S {
+    size_t size;
+    size_t block_count;
+    size_t word_count;
+    int64_t *firsts;
+    size_t *offsets;
+    uint8_t *widths;
+    uint32_t *words;
+} * HHCompressedArray;
+
+#define _HHCOMPRESSEDARRAY_DEFINED_
+#include "HHCompressedArray.h"
+#undef _HHCOMPRESSEDARRAY_DEFINED_
+
+static inline int64_t _slot_i64(void *value) {
+    return (int64_t)(intptr_t)value;
+}
+
+/**
+ * @return the number of 32-bit words a block packed at `width` bits takes.
+ */
+static inline size_t _block_words(unsigned width) {
+    if (width > 32) return BLOCK_SIZE * 2;
+    return LANES * ((ROWS * width + 31) / 32);
+}
+
+static inline size_t _block_length(HHCompressedArray array, size_t block) {
+    return min(BLOCK_SIZE, array->size - (block << BLOCK_SHIFT));
+}
+
+/**
+ * Fills `gaps` with the gaps of the block starting at `start`, padding
+ * past the end of the array with zeroes.
+ * @return the largest gap.
+ */
+static uint64_t _block_gaps(HHArray array, size_t start, uint64_t *gaps) {
+    size_t count = min(BLOCK_SIZE, array->size - start);
+    uint64_t largest = 0;
+    gaps[0] = 0;
+    for (size_t j = 1; j < count; j++) {
+        gaps[j] = (uint64_t)_slot_i64(array->values[start + j]) - (uint64_t)_slot_i64(array->values[start + j - 1]);
+        if (gaps[j] > largest) largest = gaps[j];
+    }
+    for (size_t j = count; j < BLOCK_SIZE; j++) {
+        gaps[j] = 0;
+    }
+    return largest;
+}
+
+/**
+ * Packs a block of gaps into zeroed `words`.
+ */
+static void _pack(const uint64_t *gaps, unsigned width, uint32_t *words) {
+    if (width > 32) {
+        memcpy(words, gaps, BLOCK_SIZE * sizeof(uint64_t));
+        return;
+    }
+    for (size_t j = 0; j < BLOCK_SIZE && width > 0; j++) {
+        size_t lane = j % LANES;
+        size_t bit = (j / LANES) * width;
+        size_t word = bit >> 5;
+        unsigned shift = bit & 31;
+        uint32_t gap = (uint32_t)gaps[j];
+        words[word * LANES + lane] |= gap << shift;
+        if (shift + width > 32) {
+            words[(word + 1) * LANES + lane] |= gap >> (32 - shift);
+        }
+    }
+}
+
+/**
+ * Unpacks the first `rows` rows of a block packed at `width <= 32` bits.
+ */
+static void _unpack(const uint32_t *words, unsigned width, size_t rows, uint32_t *out) {
+    if (width == 0) {
+        memset(out, 0, rows * LANES * sizeof(uint32_t));
+        return;
+    }
+    uint32_t mask = width == 32 ? UINT32_MAX : ((uint32_t)1 << width) - 1;
+    size_t row = 0;
+#ifdef HHARRAY_AVX2
+    __m256i lane_mask = _mm256_set1_epi32((int)mask);
+    for (; row < rows; row++) {
+        size_t bit = row * width;
+        size_t word = bit >> 5;
+        unsigned shift = bit & 31;
+        __m256i low = _mm256_loadu_si256((const __m256i *)&words[word * LANES]);
+        __m256i v = _mm256_srl_epi32(low, _mm_cvtsi32_si128((int)shift));
+        if (shift + width > 32) {
+            __m256i high = _mm256_loadu_si256((const __m256i *)&words[(word + 1) * LANES]);
+            v = _mm256_or_si256(v, _mm256_sll_epi32(high, _mm_cvtsi32_si128((int)(32 - shift))));
+        }
+        _mm256_storeu_si256((__m256i *)&out[row * LANES], _mm256_and_si256(v, lane_mask));
+    }
+#endif
+    for (; row < rows; row++) {
+        size_t bit = row * width;
+        size_t word = bit >> 5;
+        unsigned shift = bit & 31;
+        for (size_t lane = 0; lane < LANES; lane++) {
+            uint32_t v = words[word * LANES + lane] >> shift;
+            if (shift + width > 32) {
+                v |= words[(word + 1) * LANES + lane] << (32 - shift);
+            }
+            out[row * LANES + lane] = v & mask;
+        }
+    }
+}
+
+/**
+ * Decodes the first `count` values of `block` into `out`.
+ */
+static void _decode_block(HHCompressedArray array, size_t block, size_t count, int64_t *out) {
+    unsigned width = array->widths[block];
+    const uint32_t *words = &array->words[array->offsets[block]];
+    uint64_t current = (uint64_t)array->firsts[block];
+    if (width > 32) {
+        for (size_t j = 0; j < count; j++) {
+            uint64_t gap;
+            memcpy(&gap, &words[j * 2], sizeof(gap));
+            current += gap;
+            out[j] = (int64_t)current;
+        }
+        return;
+    }
+    uint32_t gaps[BLOCK_SIZE];
+    _unpack(words, width, (count + LANES - 1) / LANES, gaps);
+    for (size_t j = 0; j < count; j++) {
+        current += gaps[j];
+        out[j] = (int64_t)current;
+    }
+}
+
+#pragma mark - Creation and Destruction
+
+HHCompressedArray hharray_freeze_compressed(HHArray array) {
+    for (size_t i = 1; i < array->size; i++) {
+        if (_slot_i64(array->values[i]) < _slot_i64(array->values[i - 1])) {
+            fprintf(stderr, "Cannot compress unsorted array: index %zu is less than its predecessor.", i);
+            EXIT_WITH_FAILURE;
+            return NULL;
+        }
+    }
+    HHCompressedArray compressed = hhmalloc(sizeof(struct HHCompressedArray_S));
+    compressed->size = array->size;
+    compressed->block_count = (array->size + BLOCK_SIZE - 1) >> BLOCK_SHIFT;
+    compressed->firsts = hhcalloc(max(compressed->block_count, 1), sizeof(int64_t));
+    compressed->offsets = hhcalloc(max(compressed->block_count, 1), sizeof(size_t));
+    compressed->widths = hhcalloc(max(compressed->block_count, 1), sizeof(uint8_t));
+
+    uint64_t gaps[BLOCK_SIZE];
+    size_t word_count = 0;
+    for (size_t block = 0; block < compressed->block_count; block++) {
+        size_t start = block << BLOCK_SHIFT;
+        uint64_t largest = _block_gaps(array, start, gaps);
+        unsigned width = largest == 0 ? 0 : 64 - __builtin_clzll(largest);
+        compressed->widths[block] = width > 32 ? RAW_WIDTH : width;
+        compressed->firsts[block] = _slot_i64(array->values[start]);
+        compressed->offsets[block] = word_count;
+        word_count += _block_words(width);
+    }
+    compressed->word_count = word_count;
+    compressed->words = hhcalloc(max(word_count, 1), sizeof(uint32_t));
+    for (size_t block = 0; block < compressed->block_count; block++) {
+        _block_gaps(array, block << BLOCK_SHIFT, gaps);
+        _pack(gaps, compressed->widths[block], &compressed->words[compressed->offsets[block]]);
+    }
+    return compressed;
+}
+
+void hharray_compressed_destroy(HHCompressedArray array) {
+    free(array->firsts);
+    free(array->offsets);
+    free(array->widths);
+    free(array->words);
+    free(array);
+}
+
+size_t hharray_compressed_size(HHCompressedArray array) {
+    return array->size;
+}
+
+size_t hharray_compressed_memory(HHCompressedArray array) {
+    size_t per_block = sizeof(int64_t) + sizeof(size_t) + sizeof(uint8_t);
+    return sizeof(struct HHCompressedArray_S) + array->block_count * per_block +
+           array->word_count * sizeof(uint32_t);
+}
+
+#pragma mark - Access
+
+int64_t hharray_compressed_get(HHCompressedArray array, size_t index) {
+    if (!check_index(array->size, index)) return 0;
+    size_t block = index >> BLOCK_SHIFT;
+    size_t offset = index & (BLOCK_SIZE - 1);
+    if (offset == 0) return array->firsts[block];
+    int64_t values[BLOCK_SIZE];
+    _decode_block(array, block, offset + 1, values);
+    return values[offset];
+}
+
+size_t hharray_compressed_lower_bound(HHCompressedArray array, int64_t value) {
+    // Find the first block that starts at or after `value`; the answer is
+    // either in the block before it or is that block's first index.
+    size_t low = 0;
+    size_t high = array->block_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (array->firsts[mid] < value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0) return 0;
+    size_t block = low - 1;
+    size_t count = _block_length(array, block);
+    int64_t values[BLOCK_SIZE];
+    _decode_block(array, block, count, values);
+    size_t offset = 1;
+    while (offset < count && values[offset] < value) {
+        offset++;
+    }
+    return (block << BLOCK_SHIFT) + offset;
+}
+
+size_t hharray_compressed_decode(HHCompressedArray array, size_t start, int64_t *out, size_t count) {
+    if (start >= array->size) return 0;
+    count = min(count, array->size - start);
+    int64_t values[BLOCK_SIZE];
+    size_t written = 0;
+    while (written < count) {
+        size_t index = start + written;
+        size_t block = index >> BLOCK_SHIFT;
+        size_t offset = index & (BLOCK_SIZE - 1);
+        size_t length = _block_length(array, block);
+        size_t take = min(length - offset, count - written);
+        if (offset == 0 && take == length) {
+            _decode_block(array, block, length, &out[written]);
+        } else {
+            _decode_block(array, block, offset + take, values);
+            memcpy(&out[written], &values[offset], take * sizeof(int64_t));
+        }
+        written += take;
+    }
+    return written;
+}
+
+HHArray hharray_compressed_thaw(HHCompressedArray array) {
+    HHArray thawed = hharray_create_capacity(max(array->size / LOAD_THRESHOLD, 1));
+    int64_t values[BLOCK_SIZE];
+    for (size_t block = 0; block < array->block_count; block++) {
+        size_t start = block << BLOCK_SHIFT;
+        size_t count = _block_length(array, block);
+        _decode_block(array, block, count, values);
+        for (size_t j = 0; j < count; j++) {
+            thawed->values[start + j] = (void *)(intptr_t)values[j];
+        }
+    }
+    thawed->size = array->size;
+    return thawed;
+}
@@ -0,0 +1,258 @@
+//
+//  HHConcurrentArray.c
+//  HHArray
+//
+//  Writers are serialized by a mutex that readers never touch. Each reader
+//  owns a slot recording the epoch it entered its read section in, or 0
+//  when it is outside one. A buffer retired in epoch `e` can be freed once
+//  every slot is either 0 or greater than `e`: any reader that entered
+//  after the epoch advanced past `e` already sees the newer buffer.
+//
+
+#include <pthread.h>
+#include "HHArrayPrivate.h"
+
+#define CACHE_LINE_SIZE 64
+
+/**
+ * A published buffer. Readers load `size` with acquire ordering, so
+ * values written below it beforehand are visible.
+ */
+typedef struct {
+    size_t size;
+    size_t capacity;
+    void *values[];
+} HHConcurrentBuffer;
+
+typedef struct {
+    HHConcurrentBuffer *buffer;
+    uint64_t epoch;
+} HHRetiredBuffer;
+
+struct HHConcurrentArray_S;
+
+/**
+ * A reader's slot, aligned to a cache line so that readers entering and
+ * leaving sections don't contend with each other.
+ */
+typedef struct __attribute__((aligned(CACHE_LINE_SIZE))) HHConcurrentReader_S {
+    uint64_t epoch;
+    HHConcurrentBuffer *buffer;
+    struct HHConcurrentArray_S *array;
+    int registered;
+} * HHConcurrentReader;
+
+typedef struct HHConcurrentArray_S {
+    HHConcurrentBuffer *buffer;
+    uint64_t epoch;
+    pthread_mutex_t write_lock;
+    struct HHConcurrentReader_S *readers;
+    size_t max_readers;
+    HHRetiredBuffer *retired;
+    size_t retired_count;
+    size_t retired_capacity;
+} * HHConcurrentArray;
+
+#define _HHCONCURRENTARRAY_DEFINED_
+#include "HHConcurrentArray.h"
+#undef _HHCONCURRENTARRAY_DEFINED_
+
+static HHConcurrentBuffer *_buffer_create(size_t capacity) {
+    HHConcurrentBuffer *buffer = hhmalloc(sizeof(HHConcurrentBuffer) + capacity * ITEM_SIZE);
+    buffer->capacity = capacity;
+    return buffer;
+}
+
+#pragma mark - Creation and Destruction
+
+HHConcurrentArray hharray_concurrent_create(size_t capacity, size_t max_readers) {
+    HHConcurrentArray array = hhmalloc(sizeof(struct HHConcurrentArray_S));
+    array->buffer = _buffer_create(max(capacity, DEFAULT_CAPACITY));
+    array->epoch = 1;
+    pthread_mutex_init(&array->write_lock, NULL);
+    array->max_readers = max(max_readers, 1);
+    void *readers = NULL;
+    if (posix_memalign(&readers, CACHE_LINE_SIZE, array->max_readers * sizeof(struct HHConcurrentReader_S)) != 0) {
+        perror("posix_memalign");
+        exit(EXIT_FAILURE);
+    }
+    memset(readers, 0, array->max_readers * sizeof(struct HHConcurrentReader_S));
+    array->readers = readers;
+    return array;
+}
+
+void hharray_concurrent_destroy(HHConcurrentArray array) {
+    for (size_t i = 0; i < array->retired_count; i++) {
+        free(array->retired[i].buffer);
+    }
+    free(array->retired);
+    free(array->readers);
+    free(array->buffer);
+    pthread_mutex_destroy(&array->write_lock);
+    free(array);
+}
+
+#pragma mark - Readers
+
+HHConcurrentReader hharray_concurrent_reader_register(HHConcurrentArray array) {
+    for (size_t i = 0; i < array->max_readers; i++) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&array->readers[i].registered, &expected, 1, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            HHConcurrentReader reader = &array->readers[i];
+            reader->array = array;
+            return reader;
+        }
+    }
+    return NULL;
+}
+
+void hharray_concurrent_reader_release(HHConcurrentReader reader) {
+    __atomic_store_n(&reader->registered, 0, __ATOMIC_RELEASE);
+}
+
+void hharray_concurrent_read_begin(HHConcurrentReader reader) {
+    uint64_t epoch = __atomic_load_n(&reader->array->epoch, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&reader->epoch, epoch, __ATOMIC_RELAXED);
+    // Orders the epoch store before the buffer load, pairing with the
+    // writer's fence between publishing and scanning reader epochs.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    reader->buffer = __atomic_load_n(&reader->array->buffer, __ATOMIC_ACQUIRE);
+}
+
+void hharray_concurrent_read_end(HHConcurrentReader reader) {
+    reader->buffer = NULL;
+    __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+}
+
+size_t hharray_concurrent_size(HHConcurrentReader reader) {
+    return __atomic_load_n(&reader->buffer->size, __ATOMIC_ACQUIRE);
+}
+
+void *hharray_concurrent_get(HHConcurrentReader reader, size_t index) {
+    HHConcurrentBuffer *buffer = reader->buffer;
+    if (!check_index(__atomic_load_n(&buffer->size, __ATOMIC_ACQUIRE), index)) return NULL;
+    return __atomic_load_n(&buffer->values[index], __ATOMIC_RELAXED);
+}
+
+size_t hharray_concurrent_find_f(HHConcurrentReader reader, void *element, int (*is_equal)(void *, void *)) {
+    HHConcurrentBuffer *buffer = reader->buffer;
+    size_t size = __atomic_load_n(&buffer->size, __ATOMIC_ACQUIRE);
+    for (size_t i = 0; i < size; i++) {
+        void *value = __atomic_load_n(&buffer->values[i], __ATOMIC_RELAXED);
+        if (is_equal ? is_equal(element, value) : element == value) {
+            return i;
+        }
+    }
+    return HHArrayNotFound;
+}
+
+#pragma mark - Reclamation
+
+/**
+ * Frees every retired buffer that no reader can still be using.
+ * @pre the write lock is held.
+ */
+static void _reclaim(HHConcurrentArray array) {
+    uint64_t oldest = UINT64_MAX;
+    for (size_t i = 0; i < array->max_readers; i++) {
+        uint64_t epoch = __atomic_load_n(&array->readers[i].epoch, __ATOMIC_ACQUIRE);
+        if (epoch != 0 && epoch < oldest) oldest = epoch;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < array->retired_count; i++) {
+        if (array->retired[i].epoch < oldest) {
+            free(array->retired[i].buffer);
+        } else {
+            array->retired[kept++] = array->retired[i];
+        }
+    }
+    array->retired_count = kept;
+}
+
+/**
+ * Makes `buffer` the array's current buffer, retires the old one, and
+ * frees whatever earlier buffers are no longer visible to any reader.
+ * @pre the write lock is held.
+ */
+static void _publish(HHConcurrentArray array, HHConcurrentBuffer *buffer) {
+    HHConcurrentBuffer *old = array->buffer;
+    __atomic_store_n(&array->buffer, buffer, __ATOMIC_RELEASE);
+    if (array->retired_count == array->retired_capacity) {
+        array->retired_capacity = max(array->retired_capacity * 2, 4);
+        array->retired = hhrealloc(array->retired, array->retired_capacity * sizeof(HHRetiredBuffer));
+    }
+    array->retired[array->retired_count++] = (HHRetiredBuffer){old, array->epoch};
+    __atomic_store_n(&array->epoch, array->epoch + 1, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    _reclaim(array);
+}
+
+#pragma mark - Writers
+
+void hharray_concurrent_append(HHConcurrentArray array, void *value) {
+    pthread_mutex_lock(&array->write_lock);
+    HHConcurrentBuffer *buffer = array->buffer;
+    size_t size = buffer->size;
+    if (size < buffer->capacity) {
+        __atomic_store_n(&buffer->values[size], value, __ATOMIC_RELAXED);
+        __atomic_store_n(&buffer->size, size + 1, __ATOMIC_RELEASE);
+    } else {
+        HHConcurrentBuffer *grown = _buffer_create(buffer->capacity * RESIZE_FACTOR + 1);
+        memcpy(grown->values, buffer->values, size * ITEM_SIZE);
+        grown->values[size] = value;
+        grown->size = size + 1;
+        _publish(array, grown);
+    }
+    pthread_mutex_unlock(&array->write_lock);
+}
+
+void hharray_concurrent_set(HHConcurrentArray array, size_t index, void *value) {
+    pthread_mutex_lock(&array->write_lock);
+    HHConcurrentBuffer *buffer = array->buffer;
+    if (check_index(buffer->size, index)) {
+        __atomic_store_n(&buffer->values[index], value, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&array->write_lock);
+}
+
+void hharray_concurrent_insert_index(HHConcurrentArray array, void *value, size_t index) {
+    pthread_mutex_lock(&array->write_lock);
+    HHConcurrentBuffer *buffer = array->buffer;
+    if (check_index(buffer->size + 1, index)) {
+        size_t capacity = buffer->size < buffer->capacity ? buffer->capacity : buffer->capacity * RESIZE_FACTOR + 1;
+        HHConcurrentBuffer *inserted = _buffer_create(capacity);
+        memcpy(inserted->values, buffer->values, index * ITEM_SIZE);
+        inserted->values[index] = value;
+        memcpy(&inserted->values[index + 1], &buffer->values[index], (buffer->size - index) * ITEM_SIZE);
+        inserted->size = buffer->size + 1;
+        _publish(array, inserted);
+    }
+    pthread_mutex_unlock(&array->write_lock);
+}
+
+void *hharray_concurrent_remove_index(HHConcurrentArray array, size_t index) {
+    void *value = NULL;
+    pthread_mutex_lock(&array->write_lock);
+    HHConcurrentBuffer *buffer = array->buffer;
+    if (check_index(buffer->size, index)) {
+        value = buffer->values[index];
+        HHConcurrentBuffer *removed = _buffer_create(buffer->capacity);
+        memcpy(removed->values, buffer->values, index * ITEM_SIZE);
+        memcpy(&removed->values[index], &buffer->values[index + 1], (buffer->size - index - 1) * ITEM_SIZE);
+        removed->size = buffer->size - 1;
+        _publish(array, removed);
+    }
+    pthread_mutex_unlock(&array->write_lock);
+    return value;
+}
+
+HHArray hharray_concurrent_copy(HHConcurrentArray array) {
+    pthread_mutex_lock(&array->write_lock);
+    HHConcurrentBuffer *buffer = array->buffer;
+    HHArray copy = hharray_create_capacity(max(buffer->size / LOAD_THRESHOLD, 1));
+    memcpy(copy->values, buffer->values, buffer->size * ITEM_SIZE);
+    copy->size = buffer->size;
+    pthread_mutex_unlock(&array->write_lock);
+    return copy;
+}
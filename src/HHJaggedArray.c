@@ -0,0 +1,233 @@
+//
+//  HHJaggedArray.c
+//  HHArray
+//
+//  Row `r` holds `values[offsets[r]]` up to, but not including,
+//  `values[offsets[r + 1]]`, so `offsets` always has one more entry than
+//  there are rows and its last entry is the total number of values.
+//
+
+#include "HHArrayPrivate.h"
+
+static const size_t PARALLEL_FILL_THRESHOLD = 1 << 16;
+
+typedef struct HHJaggedArray_S {
+    size_t size;
+    size_t capacity;
+    void **values;
+    size_t row_count;
+    size_t offsets_capacity;
+    size_t *offsets;
+} * HHJaggedArray;
+
+#define _HHJAGGEDARRAY_DEFINED_
+#include "HHJaggedArray.h"
+#undef _HHJAGGEDARRAY_DEFINED_
+
+/**
+ * @return the capacity to grow from `capacity` to, so that it holds `needed`
+ *         entries within the load threshold.
+ */
+static size_t _grown_capacity(size_t capacity, size_t needed) {
+    if (!hharray_policy_should_grow(needed, capacity)) return capacity;
+    return max(hharray_policy_grown_capacity(capacity), hharray_policy_capacity_for(needed));
+}
+
+static void _reserve_values(HHJaggedArray array, size_t count) {
+    size_t capacity = _grown_capacity(array->capacity, array->size + count);
+    if (capacity == array->capacity) return;
+    array->values = hhrealloc(array->values, capacity * ITEM_SIZE);
+    array->capacity = capacity;
+}
+
+static void _reserve_row(HHJaggedArray array) {
+    size_t capacity = _grown_capacity(array->offsets_capacity, array->row_count + 2);
+    if (capacity == array->offsets_capacity) return;
+    array->offsets = hhrealloc(array->offsets, capacity * sizeof(size_t));
+    array->offsets_capacity = capacity;
+}
+
+/**
+ * Allocates a jagged array with room for exactly `capacity` values and
+ * `row_count` rows. Later appends grow it by the usual policy.
+ */
+static HHJaggedArray _jagged_create(size_t capacity, size_t row_count) {
+    HHJaggedArray array = hhmalloc(sizeof(struct HHJaggedArray_S));
+    array->capacity = max(capacity, 1);
+    array->values = hhcalloc(array->capacity, ITEM_SIZE);
+    array->offsets_capacity = row_count + 1;
+    array->offsets = hhcalloc(array->offsets_capacity, sizeof(size_t));
+    return array;
+}
+
+#pragma mark - Creation and Destruction
+
+HHJaggedArray hharray_jagged_create() {
+    return _jagged_create(DEFAULT_CAPACITY, DEFAULT_CAPACITY);
+}
+
+typedef struct {
+    HHJaggedArray array;
+    size_t first_row;
+    size_t end_row;
+    void (*fill)(size_t row, void **values, size_t count, void *context);
+    void *context;
+} HHJaggedFillTask;
+
+static void *_fill_task(void *argument) {
+    HHJaggedFillTask *task = argument;
+    HHJaggedArray array = task->array;
+    for (size_t row = task->first_row; row < task->end_row; row++) {
+        size_t start = array->offsets[row];
+        task->fill(row, &array->values[start], array->offsets[row + 1] - start, task->context);
+    }
+    return NULL;
+}
+
+/**
+ * @return the first row starting at or after value `index`.
+ */
+static size_t _row_at(HHJaggedArray array, size_t index) {
+    size_t low = 0;
+    size_t high = array->row_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (array->offsets[mid] < index) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+HHJaggedArray hharray_jagged_build(const size_t *counts, size_t row_count,
+                                   void (*fill)(size_t row, void **values, size_t count, void *context),
+                                   void *context, size_t threads) {
+    size_t total = 0;
+    for (size_t row = 0; row < row_count; row++) {
+        total += counts[row];
+    }
+    HHJaggedArray array = _jagged_create(total, row_count);
+    for (size_t row = 0; row < row_count; row++) {
+        array->offsets[row + 1] = array->offsets[row] + counts[row];
+    }
+    array->size = total;
+    array->row_count = row_count;
+
+    // Split rows so each task fills about the same number of values.
+    size_t task_count = max(min(threads, total / PARALLEL_FILL_THRESHOLD), 1);
+    HHJaggedFillTask *tasks = hhcalloc(task_count, sizeof(HHJaggedFillTask));
+    for (size_t i = 0; i < task_count; i++) {
+        tasks[i].array = array;
+        tasks[i].first_row = i == 0 ? 0 : _row_at(array, total / task_count * i);
+        tasks[i].end_row = row_count;
+        tasks[i].fill = fill;
+        tasks[i].context = context;
+        if (i > 0) tasks[i - 1].end_row = tasks[i].first_row;
+    }
+    hharray_run_parallel(tasks, sizeof(HHJaggedFillTask), task_count, _fill_task);
+    free(tasks);
+    return array;
+}
+
+void hharray_jagged_destroy(HHJaggedArray array) {
+    free(array->values);
+    free(array->offsets);
+    free(array);
+}
+
+size_t hharray_jagged_row_count(HHJaggedArray array) {
+    return array->row_count;
+}
+
+size_t hharray_jagged_size(HHJaggedArray array) {
+    return array->size;
+}
+
+#pragma mark - Insertion
+
+void hharray_jagged_append_row(HHJaggedArray array, void *const *values, size_t count) {
+    _reserve_row(array);
+    _reserve_values(array, count);
+    if (count > 0) {
+        memcpy(&array->values[array->size], values, count * ITEM_SIZE);
+    }
+    array->size += count;
+    array->offsets[++array->row_count] = array->size;
+}
+
+void hharray_jagged_append(HHJaggedArray array, void *value) {
+    if (array->row_count == 0) {
+        fputs("Cannot append to the last row of an array with no rows.\n", stderr);
+        EXIT_WITH_FAILURE;
+        return;
+    }
+    _reserve_values(array, 1);
+    array->values[array->size++] = value;
+    array->offsets[array->row_count] = array->size;
+}
+
+#pragma mark - Access
+
+void **hharray_jagged_row(HHJaggedArray array, size_t row, size_t *count) {
+    if (!check_index(array->row_count, row)) {
+        *count = 0;
+        return NULL;
+    }
+    *count = array->offsets[row + 1] - array->offsets[row];
+    return &array->values[array->offsets[row]];
+}
+
+size_t hharray_jagged_row_size(HHJaggedArray array, size_t row) {
+    if (!check_index(array->row_count, row)) return 0;
+    return array->offsets[row + 1] - array->offsets[row];
+}
+
+void *hharray_jagged_get(HHJaggedArray array, size_t row, size_t column) {
+    if (!check_index(array->row_count, row)) return NULL;
+    size_t start = array->offsets[row];
+    if (!check_index(array->offsets[row + 1] - start, column)) return NULL;
+    return array->values[start + column];
+}
+
+void hharray_jagged_for_each(HHJaggedArray array,
+                             void (*visit)(size_t row, void **values, size_t count, void *context),
+                             void *context) {
+    for (size_t row = 0; row < array->row_count; row++) {
+        size_t start = array->offsets[row];
+        visit(row, &array->values[start], array->offsets[row + 1] - start, context);
+    }
+}
+
+#pragma mark - Conversion
+
+HHJaggedArray hharray_jagged_from_nested(HHArray rows) {
+    size_t total = 0;
+    for (size_t row = 0; row < rows->size; row++) {
+        total += ((HHArray)rows->values[row])->size;
+    }
+    HHJaggedArray array = _jagged_create(total, rows->size);
+    for (size_t row = 0; row < rows->size; row++) {
+        HHArray source = rows->values[row];
+        memcpy(&array->values[array->size], source->values, source->size * ITEM_SIZE);
+        array->size += source->size;
+        array->offsets[row + 1] = array->size;
+    }
+    array->row_count = rows->size;
+    return array;
+}
+
+HHArray hharray_jagged_to_nested(HHJaggedArray array) {
+    HHArray rows = hharray_create_capacity(max(array->row_count / LOAD_THRESHOLD, 1));
+    for (size_t row = 0; row < array->row_count; row++) {
+        size_t start = array->offsets[row];
+        size_t count = array->offsets[row + 1] - start;
+        HHArray copy = hharray_create_capacity(max(count / LOAD_THRESHOLD, 1));
+        memcpy(copy->values, &array->values[start], count * ITEM_SIZE);
+        copy->size = count;
+        rows->values[row] = copy;
+    }
+    rows->size = array->row_count;
+    return rows;
+}
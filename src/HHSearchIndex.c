@@ -0,0 +1,161 @@
+//
+//  HHSearchIndex.c
+//  HHArray
+//
+//  Node `k` of the implicit tree has children `2k` and `2k + 1`, with the
+//  root at 1. Slot 0 is unused, and the slots start on a cache line, so
+//  the sixteen descendants four levels below node `k`, `16k` to `16k + 15`,
+//  fill exactly two lines, which a lookup prefetches as it passes `k`.
+//  A lookup descends with `k = 2k + (node < value)`, and the bits of `k`
+//  then trace the path taken: the lower bound is the last node where the
+//  descent went left, found by stripping the trailing ones and the zero
+//  before them.
+//
+
+#include "HHArrayPrivate.h"
+
+#define CACHE_LINE_SIZE 64
+#define SLOTS_PER_LINE (CACHE_LINE_SIZE / ITEM_SIZE)
+#define PREFETCH_LEVELS 4
+
+typedef struct HHSearchIndex_S {
+    size_t size;
+    void **values;
+    int (*comparison)(const void *a, const void *b);
+} * HHSearchIndex;
+
+#define _HHSEARCHINDEX_DEFINED_
+#include "HHSearchIndex.h"
+#undef _HHSEARCHINDEX_DEFINED_
+
+static inline int64_t _slot_i64(void *value) {
+    return (int64_t)(intptr_t)value;
+}
+
+static inline unsigned _log2(size_t value) {
+    return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(value);
+}
+
+/**
+ * Fills the subtree rooted at `node` with the sorted values starting at
+ * `*next`, in order.
+ */
+static void _fill(HHSearchIndex index, void **sorted, size_t *next, size_t node) {
+    if (node > index->size) return;
+    _fill(index, sorted, next, 2 * node);
+    index->values[node] = sorted[(*next)++];
+    _fill(index, sorted, next, 2 * node + 1);
+}
+
+static HHSearchIndex _build(HHArray array, int (*comparison)(const void *a, const void *b)) {
+    HHSearchIndex index = hhmalloc(sizeof(struct HHSearchIndex_S));
+    index->size = array->size;
+    index->comparison = comparison;
+    size_t bytes = (array->size + 1) * ITEM_SIZE;
+    if (posix_memalign((void **)&index->values, CACHE_LINE_SIZE, bytes) != 0) {
+        perror("posix_memalign");
+        exit(EXIT_FAILURE);
+    }
+    size_t next = 0;
+    _fill(index, array->values, &next, 1);
+    return index;
+}
+
+HHSearchIndex hharray_build_search_index(HHArray array, int (*comparison)(const void *a, const void *b)) {
+    if (!hharray_is_sorted(array, comparison)) {
+        fputs("Cannot build a search index over an unsorted array.\n", stderr);
+        EXIT_WITH_FAILURE;
+        return NULL;
+    }
+    return _build(array, comparison);
+}
+
+HHSearchIndex hharray_build_search_index_i64(HHArray array) {
+    for (size_t i = 1; i < array->size; i++) {
+        if (_slot_i64(array->values[i]) < _slot_i64(array->values[i - 1])) {
+            fputs("Cannot build a search index over an unsorted array.\n", stderr);
+            EXIT_WITH_FAILURE;
+            return NULL;
+        }
+    }
+    return _build(array, NULL);
+}
+
+void hharray_index_destroy(HHSearchIndex index) {
+    free(index->values);
+    free(index);
+}
+
+size_t hharray_index_size(HHSearchIndex index) {
+    return index->size;
+}
+
+/**
+ * @return the position in sorted order of `node`, found without storing it.
+ * In a perfect tree of height `h`, the `j`th node at depth `d` has rank
+ * `(2j + 1) * 2^(h - d) - 1`, and the `i`th slot of the bottom level has
+ * rank `2i`. The real tree lacks the bottom slots from `leaves` on, so
+ * subtract those that come before the node.
+ */
+static inline size_t _rank(HHSearchIndex index, size_t node) {
+    unsigned height = _log2(index->size);
+    unsigned depth = _log2(node);
+    size_t leaves = index->size - ((size_t)1 << height) + 1;
+    size_t rank = ((2 * (node - ((size_t)1 << depth)) + 1) << (height - depth)) - 1;
+    size_t bottom_before = (rank + 1) / 2;
+    return bottom_before > leaves ? rank - (bottom_before - leaves) : rank;
+}
+
+/**
+ * Prefetches the sixteen descendants four levels below `node`.
+ * Only an address is formed here; prefetching past the end is harmless.
+ */
+static inline void _prefetch_descendants(void **values, size_t node) {
+    char *descendants = (char *)values + (node << PREFETCH_LEVELS) * ITEM_SIZE;
+    __builtin_prefetch(descendants);
+    __builtin_prefetch(descendants + (((size_t)1 << PREFETCH_LEVELS) - SLOTS_PER_LINE) * ITEM_SIZE);
+}
+
+/**
+ * @return the node holding the lower bound of `value`, or 0 if every value is less.
+ */
+static inline size_t _lower_bound_node(HHSearchIndex index, void *value) {
+    void **values = index->values;
+    size_t size = index->size;
+    size_t node = 1;
+    if (!index->comparison) {
+        int64_t key = _slot_i64(value);
+        while (node <= size) {
+            _prefetch_descendants(values, node);
+            node = 2 * node + (_slot_i64(values[node]) < key);
+        }
+    } else {
+        while (node <= size) {
+            _prefetch_descendants(values, node);
+            node = 2 * node + (index->comparison(&values[node], &value) < 0);
+        }
+    }
+    return node >> __builtin_ffsll((long long)~node);
+}
+
+static inline int _equal(HHSearchIndex index, void *a, void *b) {
+    if (!index->comparison) return a == b;
+    return index->comparison(&a, &b) == 0;
+}
+
+size_t hharray_index_lower_bound(HHSearchIndex index, void *value) {
+    size_t node = _lower_bound_node(index, value);
+    return node == 0 ? index->size : _rank(index, node);
+}
+
+size_t hharray_index_find(HHSearchIndex index, void *value) {
+    size_t node = _lower_bound_node(index, value);
+    if (node == 0 || !_equal(index, index->values[node], value)) {
+        return HHArrayNotFound;
+    }
+    return _rank(index, node);
+}
+
+size_t hharray_index_lower_bound_i64(HHSearchIndex index, int64_t value) {
+    return hharray_index_lower_bound(index, (void *)(intptr_t)value);
+}
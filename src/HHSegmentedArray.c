@@ -0,0 +1,170 @@
+//
+//  HHSegmentedArray.c
+//  HHArray
+//
+//  Segment `s` holds `SEGMENT_BASE << s` values, so the first `s` segments
+//  hold `SEGMENT_BASE * (2^s - 1)` values in total. Adding `SEGMENT_BASE`
+//  to an index makes its highest set bit name its segment.
+//
+
+#include "HHArrayPrivate.h"
+
+#define SEGMENT_BASE_SHIFT 4
+#define SEGMENT_BASE ((size_t)1 << SEGMENT_BASE_SHIFT)
+#define MAX_SEGMENTS (sizeof(size_t) * 8 - SEGMENT_BASE_SHIFT)
+
+typedef struct HHSegmentedArray_S {
+    size_t size;
+    size_t capacity;
+    size_t segment_count;
+    void **segments[MAX_SEGMENTS];
+} * HHSegmentedArray;
+
+#define _HHSEGMENTEDARRAY_DEFINED_
+#include "HHSegmentedArray.h"
+#undef _HHSEGMENTEDARRAY_DEFINED_
+
+static inline size_t _segment_size(size_t segment) {
+    return SEGMENT_BASE << segment;
+}
+
+/**
+ * @return the slot at `index`, without bounds checks.
+ */
+static inline void **_segmented_slot(HHSegmentedArray array, size_t index) {
+    size_t shifted = index + SEGMENT_BASE;
+    size_t high_bit = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(shifted);
+    return &array->segments[high_bit - SEGMENT_BASE_SHIFT][shifted - ((size_t)1 << high_bit)];
+}
+
+#pragma mark - Creation and Destruction
+
+HHSegmentedArray hharray_segmented_create() {
+    return hhmalloc(sizeof(struct HHSegmentedArray_S));
+}
+
+void hharray_segmented_destroy(HHSegmentedArray array) {
+    for (size_t i = 0; i < array->segment_count; i++) {
+        free(array->segments[i]);
+    }
+    free(array);
+}
+
+size_t hharray_segmented_size(HHSegmentedArray array) {
+    return array->size;
+}
+
+#pragma mark - Insertion and Removal
+
+void hharray_segmented_append(HHSegmentedArray array, void *value) {
+    if (array->size == array->capacity) {
+        size_t segment_size = _segment_size(array->segment_count);
+        array->segments[array->segment_count++] = hhcalloc(segment_size, ITEM_SIZE);
+        array->capacity += segment_size;
+    }
+    *_segmented_slot(array, array->size) = value;
+    array->size++;
+}
+
+void *hharray_segmented_remove_last(HHSegmentedArray array) {
+    if (array->size == 0) {
+        fputs("Cannot remove from an empty array.\n", stderr);
+        EXIT_WITH_FAILURE;
+        return NULL;
+    }
+    array->size--;
+    void **slot = _segmented_slot(array, array->size);
+    void *value = *slot;
+    *slot = NULL;
+    return value;
+}
+
+void *hharray_segmented_get(HHSegmentedArray array, size_t index) {
+    if (!check_index(array->size, index)) return NULL;
+    return *_segmented_slot(array, index);
+}
+
+void hharray_segmented_set(HHSegmentedArray array, size_t index, void *value) {
+    if (!check_index(array->size, index)) return;
+    *_segmented_slot(array, index) = value;
+}
+
+void **hharray_segmented_slot(HHSegmentedArray array, size_t index) {
+    if (!check_index(array->size, index)) return NULL;
+    return _segmented_slot(array, index);
+}
+
+#pragma mark - Segment Iteration
+
+size_t hharray_segmented_segment_count(HHSegmentedArray array) {
+    if (array->size == 0) return 0;
+    size_t shifted = array->size - 1 + SEGMENT_BASE;
+    return sizeof(unsigned long long) * 8 - __builtin_clzll(shifted) - SEGMENT_BASE_SHIFT;
+}
+
+void **hharray_segmented_segment(HHSegmentedArray array, size_t segment, size_t *count) {
+    if (segment >= hharray_segmented_segment_count(array)) {
+        fprintf(stderr, "Segment %zu is past the array's last segment.", segment);
+        EXIT_WITH_FAILURE;
+        *count = 0;
+        return NULL;
+    }
+    size_t start = SEGMENT_BASE * (((size_t)1 << segment) - 1);
+    *count = min(_segment_size(segment), array->size - start);
+    return array->segments[segment];
+}
+
+#pragma mark - Functional Abstractions
+
+HHSegmentedArray hharray_segmented_map(HHSegmentedArray array, void *(*transform)(void *)) {
+    HHSegmentedArray new = hharray_segmented_create();
+    size_t segments = hharray_segmented_segment_count(array);
+    for (size_t s = 0; s < segments; s++) {
+        size_t count;
+        void **values = hharray_segmented_segment(array, s, &count);
+        for (size_t i = 0; i < count; i++) {
+            hharray_segmented_append(new, transform(values[i]));
+        }
+    }
+    return new;
+}
+
+HHSegmentedArray hharray_segmented_filter(HHSegmentedArray array, int (*include)(void *)) {
+    HHSegmentedArray new = hharray_segmented_create();
+    size_t segments = hharray_segmented_segment_count(array);
+    for (size_t s = 0; s < segments; s++) {
+        size_t count;
+        void **values = hharray_segmented_segment(array, s, &count);
+        for (size_t i = 0; i < count; i++) {
+            if (include(values[i])) {
+                hharray_segmented_append(new, values[i]);
+            }
+        }
+    }
+    return new;
+}
+
+void *hharray_segmented_reduce(HHSegmentedArray array, void *initial, void *(*combine)(void *, void *)) {
+    void *current = initial;
+    size_t segments = hharray_segmented_segment_count(array);
+    for (size_t s = 0; s < segments; s++) {
+        size_t count;
+        void **values = hharray_segmented_segment(array, s, &count);
+        for (size_t i = 0; i < count; i++) {
+            current = combine(current, values[i]);
+        }
+    }
+    return current;
+}
+
+HHArray hharray_segmented_to_array(HHSegmentedArray array) {
+    HHArray new = hharray_create_capacity(max(array->size / LOAD_THRESHOLD, 1));
+    size_t segments = hharray_segmented_segment_count(array);
+    for (size_t s = 0; s < segments; s++) {
+        size_t count;
+        void **values = hharray_segmented_segment(array, s, &count);
+        memcpy(&new->values[new->size], values, count * ITEM_SIZE);
+        new->size += count;
+    }
+    return new;
+}
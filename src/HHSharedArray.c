@@ -0,0 +1,313 @@
+//
+//  HHSharedArray.c
+//  HHArray
+//
+//  The shared memory object holds a header page followed by the slots.
+//  Each process maps the header once and the slots separately, so that
+//  growing only remaps the slots while the process-shared lock and
+//  condition variable in the header keep a fixed address.
+//
+//  A process growing the array extends the object, publishes the new
+//  capacity and then bumps the generation with release ordering. Since
+//  it grows before storing a size past the old capacity, a process that
+//  loads the size with acquire ordering and finds an index beyond its
+//  own mapping is guaranteed to see the new generation, and remaps.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "HHArrayPrivate.h"
+
+#define SHARED_MAGIC 0x2179617272414848ULL /* "HHArray!" */
+
+typedef struct {
+    uint64_t magic;
+    uint64_t header_size;
+    uint64_t generation;
+    uint64_t capacity;
+    uint64_t size;
+    uint64_t consumed;
+    int closed;
+    pthread_mutex_t lock;
+    pthread_cond_t appended;
+} HHSharedHeader;
+
+typedef struct HHSharedArray_S {
+    int fd;
+    size_t header_size;
+    HHSharedHeader *header;
+    uint64_t *values;
+    size_t capacity;
+    uint64_t generation;
+} * HHSharedArray;
+
+#define _HHSHAREDARRAY_DEFINED_
+#include "HHSharedArray.h"
+#undef _HHSHAREDARRAY_DEFINED_
+
+static size_t _header_size(void) {
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = page_size;
+    while (size < sizeof(HHSharedHeader)) {
+        size += page_size;
+    }
+    return size;
+}
+
+static void _shared_error(const char *action, const char *name) {
+    fprintf(stderr, "Cannot %s shared array %s: %s\n", action, name, strerror(errno));
+    EXIT_WITH_FAILURE;
+}
+
+/**
+ * Locks the header, recovering the lock if its owner died holding it.
+ */
+static void _lock(HHSharedHeader *header) {
+    if (pthread_mutex_lock(&header->lock) == EOWNERDEAD) {
+        pthread_mutex_consistent(&header->lock);
+    }
+}
+
+static void _unlock(HHSharedHeader *header) {
+    pthread_mutex_unlock(&header->lock);
+}
+
+/**
+ * Maps `capacity` slots, replacing any existing mapping of the slots.
+ */
+static void _map_values(HHSharedArray array, size_t capacity) {
+    if (array->values) {
+        munmap(array->values, array->capacity * sizeof(uint64_t));
+    }
+    void *values = mmap(NULL, capacity * sizeof(uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED,
+                        array->fd, (off_t)array->header_size);
+    if (values == MAP_FAILED) {
+        perror("mmap");
+        exit(EXIT_FAILURE);
+    }
+    array->values = values;
+    array->capacity = capacity;
+}
+
+/**
+ * Remaps the slots if another process has grown the array since this
+ * process last mapped them.
+ */
+static void _refresh(HHSharedArray array) {
+    uint64_t generation = __atomic_load_n(&array->header->generation, __ATOMIC_ACQUIRE);
+    if (generation == array->generation) return;
+    _map_values(array, __atomic_load_n(&array->header->capacity, __ATOMIC_RELAXED));
+    array->generation = generation;
+}
+
+/**
+ * Grows the array to hold at least `capacity` slots.
+ * @pre the caller holds the header's lock and has refreshed its mapping.
+ */
+static void _grow_locked(HHSharedArray array, size_t capacity) {
+    if (ftruncate(array->fd, (off_t)(array->header_size + capacity * sizeof(uint64_t))) != 0) {
+        perror("ftruncate");
+        exit(EXIT_FAILURE);
+    }
+    _map_values(array, capacity);
+    __atomic_store_n(&array->header->capacity, capacity, __ATOMIC_RELAXED);
+    array->generation = __atomic_add_fetch(&array->header->generation, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Makes room for `count` more values.
+ * @pre the caller holds the header's lock.
+ */
+static void _reserve_locked(HHSharedArray array, size_t count) {
+    _refresh(array);
+    size_t needed = array->header->size + count;
+    if (!hharray_policy_should_grow(needed, array->capacity)) return;
+    _grow_locked(array, max(hharray_policy_grown_capacity(array->capacity), hharray_policy_capacity_for(needed)));
+}
+
+#pragma mark - Creation and Destruction
+
+static HHSharedArray _attach(int fd, HHSharedHeader *header, size_t header_size) {
+    HHSharedArray array = hhmalloc(sizeof(struct HHSharedArray_S));
+    array->fd = fd;
+    array->header = header;
+    array->header_size = header_size;
+    array->generation = __atomic_load_n(&header->generation, __ATOMIC_ACQUIRE);
+    _map_values(array, __atomic_load_n(&header->capacity, __ATOMIC_RELAXED));
+    return array;
+}
+
+HHSharedArray hharray_create_shared(const char *name, size_t capacity) {
+    if (capacity == 0) {
+        fputs("Cannot initialize an hharray with capacity 0.\n", stderr);
+        EXIT_WITH_FAILURE;
+    }
+    capacity = max(capacity, DEFAULT_CAPACITY);
+    size_t header_size = _header_size();
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        _shared_error("create", name);
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t)(header_size + capacity * sizeof(uint64_t))) != 0) {
+        _shared_error("size", name);
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    HHSharedHeader *header = mmap(NULL, header_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (header == MAP_FAILED) {
+        perror("mmap");
+        exit(EXIT_FAILURE);
+    }
+    header->header_size = header_size;
+    header->capacity = capacity;
+
+    pthread_mutexattr_t mutex_attributes;
+    pthread_mutexattr_init(&mutex_attributes);
+    pthread_mutexattr_setpshared(&mutex_attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutex_attributes, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&header->lock, &mutex_attributes);
+    pthread_mutexattr_destroy(&mutex_attributes);
+
+    pthread_condattr_t cond_attributes;
+    pthread_condattr_init(&cond_attributes);
+    pthread_condattr_setpshared(&cond_attributes, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&header->appended, &cond_attributes);
+    pthread_condattr_destroy(&cond_attributes);
+
+    // Attaching processes check the magic number last, once all else is set up.
+    __atomic_store_n(&header->magic, SHARED_MAGIC, __ATOMIC_RELEASE);
+    return _attach(fd, header, header_size);
+}
+
+HHSharedArray hharray_attach_shared(const char *name) {
+    size_t header_size = _header_size();
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        _shared_error("open", name);
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < header_size) {
+        fprintf(stderr, "Cannot attach shared array %s: it is not an HHArray.\n", name);
+        EXIT_WITH_FAILURE;
+        close(fd);
+        return NULL;
+    }
+    HHSharedHeader *header = mmap(NULL, header_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (header == MAP_FAILED) {
+        perror("mmap");
+        exit(EXIT_FAILURE);
+    }
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != SHARED_MAGIC || header->header_size != header_size) {
+        fprintf(stderr, "Cannot attach shared array %s: it is not an HHArray.\n", name);
+        EXIT_WITH_FAILURE;
+        munmap(header, header_size);
+        close(fd);
+        return NULL;
+    }
+    return _attach(fd, header, header_size);
+}
+
+void hharray_shared_detach(HHSharedArray array) {
+    munmap(array->values, array->capacity * sizeof(uint64_t));
+    munmap(array->header, array->header_size);
+    close(array->fd);
+    free(array);
+}
+
+void hharray_shared_unlink(const char *name) {
+    if (shm_unlink(name) != 0) {
+        _shared_error("unlink", name);
+    }
+}
+
+#pragma mark - Access
+
+size_t hharray_shared_size(HHSharedArray array) {
+    return __atomic_load_n(&array->header->size, __ATOMIC_ACQUIRE);
+}
+
+uint64_t hharray_shared_get(HHSharedArray array, size_t index) {
+    if (!check_index(hharray_shared_size(array), index)) return 0;
+    if (index >= array->capacity) _refresh(array);
+    return __atomic_load_n(&array->values[index], __ATOMIC_RELAXED);
+}
+
+void hharray_shared_set(HHSharedArray array, size_t index, uint64_t value) {
+    if (!check_index(hharray_shared_size(array), index)) return;
+    if (index >= array->capacity) _refresh(array);
+    __atomic_store_n(&array->values[index], value, __ATOMIC_RELAXED);
+}
+
+uint64_t *hharray_shared_values(HHSharedArray array) {
+    _refresh(array);
+    return array->values;
+}
+
+HHArray hharray_shared_to_array(HHSharedArray array) {
+    size_t size = hharray_shared_size(array);
+    if (size > array->capacity) _refresh(array);
+    HHArray new = hharray_create_capacity(max(size / LOAD_THRESHOLD, 1));
+    for (size_t i = 0; i < size; i++) {
+        new->values[i] = (void *)(intptr_t)array->values[i];
+    }
+    new->size = size;
+    return new;
+}
+
+#pragma mark - Insertion
+
+void hharray_shared_append(HHSharedArray array, uint64_t value) {
+    hharray_shared_append_values(array, &value, 1);
+}
+
+void hharray_shared_append_values(HHSharedArray array, const uint64_t *values, size_t count) {
+    HHSharedHeader *header = array->header;
+    _lock(header);
+    _reserve_locked(array, count);
+    size_t size = header->size;
+    memcpy(&array->values[size], values, count * sizeof(uint64_t));
+    __atomic_store_n(&header->size, size + count, __ATOMIC_RELEASE);
+    pthread_cond_signal(&header->appended);
+    _unlock(header);
+}
+
+#pragma mark - Append/Consume Protocol
+
+HHArrayStatus hharray_shared_try_consume(HHSharedArray array, uint64_t *value) {
+    HHSharedHeader *header = array->header;
+    uint64_t consumed = __atomic_load_n(&header->consumed, __ATOMIC_RELAXED);
+    if (consumed >= hharray_shared_size(array)) return HHArrayStatusEmpty;
+    if (consumed >= array->capacity) _refresh(array);
+    *value = __atomic_load_n(&array->values[consumed], __ATOMIC_RELAXED);
+    __atomic_store_n(&header->consumed, consumed + 1, __ATOMIC_RELEASE);
+    return HHArrayStatusOK;
+}
+
+HHArrayStatus hharray_shared_consume(HHSharedArray array, uint64_t *value) {
+    HHSharedHeader *header = array->header;
+    for (;;) {
+        if (hharray_shared_try_consume(array, value) == HHArrayStatusOK) return HHArrayStatusOK;
+        _lock(header);
+        while (header->consumed >= header->size && !header->closed) {
+            pthread_cond_wait(&header->appended, &header->lock);
+        }
+        int drained = header->consumed >= header->size;
+        _unlock(header);
+        if (drained) return HHArrayStatusEmpty;
+    }
+}
+
+void hharray_shared_close(HHSharedArray array) {
+    HHSharedHeader *header = array->header;
+    _lock(header);
+    header->closed = 1;
+    pthread_cond_broadcast(&header->appended);
+    _unlock(header);
+}
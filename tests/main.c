@@ -11,9 +11,22 @@
 #include <time.h>
 #include <assert.h>
 #include <pthread.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 #define UNIT_TEST (Needed so tests keep running)
 #include "HHArray.h"
+#include "HHArrayInt.h"
+#include "HHCompressedArray.h"
+#include "HHSegmentedArray.h"
+#include "HHArrayBuilder.h"
+#include "HHConcurrentArray.h"
+#include "HHArrayTyped.h"
+#include "HHSharedArray.h"
+#include "HHSearchIndex.h"
+#include "HHJaggedArray.h"
 #undef UNIT_TEST
 
 #define CASTREF(Type, x) (*(Type *)x)
@@ -82,6 +95,161 @@ void test_sort() {
     hharray_destroy(array);
 }
 
+int cmp_bucket(const void *a, const void *b) {
+    return (int)(CASTREF(long, a) / 10000 - CASTREF(long, b) / 10000);
+}
+
+/**
+ * Fills `array` with values whose bucket (value / 10000) is random and whose
+ * remainder is the insertion order, so stability can be checked after sorting.
+ */
+void fill_buckets(HHArray array, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        hharray_append(array, (void *)(long)((rand() % 20) * 10000 + i));
+    }
+}
+
+void assert_stably_sorted(HHArray array) {
+    for (size_t i = 1; i < hharray_size(array); i++) {
+        long previous = (long)hharray_get(array, i - 1);
+        long current = (long)hharray_get(array, i);
+        assert(previous / 10000 <= current / 10000);
+        if (previous / 10000 == current / 10000) {
+            assert(previous % 10000 < current % 10000);
+        }
+    }
+}
+
+void test_sort_stable() {
+    printtest("Stable Sort");
+    HHArray array = hharray_create();
+    fill_buckets(array, 5000);
+    hharray_sort_stable(array, cmp_bucket);
+    assert_stably_sorted(array);
+    printf("Sorted? %s", hharray_is_sorted(array, cmp_bucket) ? "yes" : "no");
+    hharray_destroy(array);
+
+    HHArray descending = hharray_create();
+    for (long i = 1000; i > 0; i--) {
+        hharray_append(descending, (void *)i);
+    }
+    hharray_sort_stable(descending, cmpfunc);
+    for (size_t i = 0; i < hharray_size(descending); i++) {
+        assert((long)hharray_get(descending, i) == (long)i + 1);
+    }
+    hharray_destroy(descending);
+}
+
+void test_selection() {
+    printtest("Selection");
+    HHArray array = hharray_create();
+    fill_array(array, 1000);
+    HHArray sorted = hharray_copy(array);
+    hharray_sort(sorted, cmpfunc);
+
+    HHArray nth = hharray_copy(array);
+    hharray_nth_element(nth, 500, cmpfunc);
+    printf("500th element: %ld", (long)hharray_get(nth, 500));
+    assert(hharray_get(nth, 500) == hharray_get(sorted, 500));
+    for (size_t i = 0; i < hharray_size(nth); i++) {
+        long value = (long)hharray_get(nth, i);
+        assert(i < 500 ? value <= (long)hharray_get(nth, 500) : value >= (long)hharray_get(nth, 500));
+    }
+
+    HHArray partial = hharray_copy(array);
+    hharray_partial_sort(partial, 100, cmpfunc);
+    for (size_t i = 0; i < 100; i++) {
+        assert(hharray_get(partial, i) == hharray_get(sorted, i));
+    }
+
+    HHArray buckets = hharray_create();
+    fill_buckets(buckets, 1000);
+    HHArray top = hharray_top_k(buckets, 100, cmp_bucket);
+    hharray_sort_stable(buckets, cmp_bucket);
+    assert(hharray_size(top) == 100);
+    for (size_t i = 0; i < 100; i++) {
+        assert(hharray_get(top, i) == hharray_get(buckets, i));
+    }
+
+    hharray_destroy(top);
+    hharray_destroy(buckets);
+    hharray_destroy(partial);
+    hharray_destroy(nth);
+    hharray_destroy(sorted);
+    hharray_destroy(array);
+}
+
+HHArray sorted_range(long start, long end, long step) {
+    HHArray array = hharray_create();
+    for (long i = start; i < end; i += step) {
+        hharray_append(array, (void *)i);
+    }
+    return array;
+}
+
+void test_merge() {
+    printtest("Merge");
+    HHArray evens = sorted_range(0, 100, 2);
+    HHArray odds = sorted_range(1, 100, 2);
+    HHArray threes = sorted_range(0, 100, 3);
+    HHArray merged = hharray_merge_sorted(evens, odds, cmpfunc);
+    hharray_print_f(merged, print);
+    assert(hharray_size(merged) == 100);
+    for (size_t i = 0; i < 100; i++) {
+        assert((long)hharray_get(merged, i) == (long)i);
+    }
+
+    HHArray shards[] = {evens, odds, threes};
+    HHArray all = hharray_merge_k(shards, 3, cmpfunc);
+    assert(hharray_size(all) == 100 + hharray_size(threes));
+    assert(hharray_is_sorted(all, cmpfunc));
+
+    hharray_destroy(all);
+    hharray_destroy(merged);
+    hharray_destroy(threes);
+    hharray_destroy(odds);
+    hharray_destroy(evens);
+}
+
+void test_set_operations() {
+    printtest("Set Operations");
+    HHArray evens = sorted_range(0, 60, 2);
+    HHArray threes = sorted_range(0, 60, 3);
+    HHArray wide = sorted_range(0, 6000, 1);
+
+    HHArray both = hharray_intersection(evens, threes, cmpfunc);
+    fputs("Intersection: ", stdout);
+    hharray_print_f(both, print);
+    assert(hharray_size(both) == 10);
+    for (size_t i = 0; i < hharray_size(both); i++) {
+        assert((long)hharray_get(both, i) % 6 == 0);
+    }
+
+    HHArray either = hharray_union(evens, threes, cmpfunc);
+    fputs("\nUnion: ", stdout);
+    hharray_print_f(either, print);
+    assert(hharray_size(either) == 30 + 20 - 10);
+
+    HHArray only_evens = hharray_difference(evens, threes, cmpfunc);
+    fputs("\nDifference: ", stdout);
+    hharray_print_f(only_evens, print);
+    assert(hharray_size(only_evens) == 20);
+
+    HHArray galloped = hharray_intersection(wide, threes, cmpfunc);
+    assert(hharray_size(galloped) == hharray_size(threes));
+    hharray_destroy(galloped);
+    galloped = hharray_intersection(threes, wide, cmpfunc);
+    assert(hharray_size(galloped) == hharray_size(threes));
+
+    hharray_destroy(galloped);
+    hharray_destroy(only_evens);
+    hharray_destroy(either);
+    hharray_destroy(both);
+    hharray_destroy(wide);
+    hharray_destroy(threes);
+    hharray_destroy(evens);
+}
+
 void test_shuffle() {
     printtest("Shuffle");
     HHArray array = hharray_create();
@@ -95,6 +263,89 @@ void test_shuffle() {
     hharray_destroy(array);
 }
 
+int is_permutation(HHArray a, HHArray b) {
+    if (hharray_size(a) != hharray_size(b)) return 0;
+    HHArray sorted_a = hharray_copy(a);
+    HHArray sorted_b = hharray_copy(b);
+    hharray_sort(sorted_a, cmpfunc);
+    hharray_sort(sorted_b, cmpfunc);
+    int same = 1;
+    for (size_t i = 0; i < hharray_size(a) && same; i++) {
+        same = hharray_get(sorted_a, i) == hharray_get(sorted_b, i);
+    }
+    hharray_destroy(sorted_a);
+    hharray_destroy(sorted_b);
+    return same;
+}
+
+void test_shuffle_r() {
+    printtest("Shuffle (explicit state)");
+    HHRandom rng;
+    hharray_random_seed(&rng, 42);
+    HHArray array = hharray_create();
+    fill_array(array, 100);
+    HHArray original = hharray_copy(array);
+    hharray_shuffle_r(array, &rng);
+    fputs("Shuffled: ", stdout);
+    hharray_print_f(array, print);
+    assert(is_permutation(array, original));
+
+    HHArray again = hharray_copy(original);
+    hharray_random_seed(&rng, 42);
+    hharray_shuffle_r(again, &rng);
+    for (size_t i = 0; i < hharray_size(array); i++) {
+        assert(hharray_get(array, i) == hharray_get(again, i));
+    }
+    hharray_destroy(again);
+    hharray_destroy(original);
+    hharray_destroy(array);
+}
+
+void test_shuffle_parallel() {
+    printtest("Shuffle (parallel)");
+    HHRandom rng;
+    hharray_random_seed(&rng, (uint64_t)time(0));
+    HHArray array = hharray_create_capacity(1 << 20);
+    for (long i = 0; i < (1 << 19); i++) {
+        hharray_append(array, (void *)i);
+    }
+    HHArray original = hharray_copy(array);
+    hharray_shuffle_parallel(array, &rng, 4);
+    size_t fixed_points = 0;
+    for (size_t i = 0; i < hharray_size(array); i++) {
+        fixed_points += (long)hharray_get(array, i) == (long)i;
+    }
+    printf("Fixed points: %zu of %zu", fixed_points, hharray_size(array));
+    assert(fixed_points < 100);
+    assert(is_permutation(array, original));
+    hharray_destroy(original);
+    hharray_destroy(array);
+}
+
+void test_sample() {
+    printtest("Sample");
+    HHRandom rng;
+    hharray_random_seed(&rng, (uint64_t)time(0));
+    HHArray array = hharray_create();
+    for (long i = 0; i < 1000; i++) {
+        hharray_append(array, (void *)i);
+    }
+    HHArray sample = hharray_sample(array, 10, &rng);
+    hharray_print_f(sample, print);
+    assert(hharray_size(sample) == 10);
+    HHArray sorted = hharray_copy(sample);
+    hharray_sort(sorted, cmpfunc);
+    for (size_t i = 1; i < hharray_size(sorted); i++) {
+        assert(hharray_get(sorted, i - 1) != hharray_get(sorted, i));
+    }
+    HHArray everything = hharray_sample(array, 1000, &rng);
+    assert(is_permutation(everything, array));
+    hharray_destroy(everything);
+    hharray_destroy(sorted);
+    hharray_destroy(sample);
+    hharray_destroy(array);
+}
+
 void test_map() {
     printtest("Map");
     HHArray array = hharray_create();
@@ -132,6 +383,437 @@ void test_reduce() {
     hharray_destroy(array);
 }
 
+void double_batch(void *const *in, void **out, size_t count, void *context) {
+    long factor = *(long *)context;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = (void *)((long)in[i] * factor);
+    }
+}
+
+void is_even_batch(void *const *in, uint8_t *mask, size_t count, void *context) {
+    (void)context;
+    for (size_t i = 0; i < count; i++) {
+        mask[i] = (long)in[i] % 2 == 0;
+    }
+}
+
+void *add_batch(void *current, void *const *in, size_t count, void *context) {
+    long sum = (long)current;
+    for (size_t i = 0; i < count; i++) {
+        sum += (long)in[i];
+    }
+    (*(size_t *)context)++;
+    return (void *)sum;
+}
+
+void test_batch() {
+    printtest("Batch Map/Filter/Reduce");
+    HHArray array = hharray_create();
+    fill_array(array, 5000);
+    long factor = 2;
+    HHArray doubled = hharray_map_batch(array, double_batch, &factor);
+    HHArray expected_doubled = hharray_map(array, double_ptr);
+    HHArray evens = hharray_filter_batch(array, is_even_batch, NULL);
+    HHArray expected_evens = hharray_filter(array, is_even);
+    size_t calls = 0;
+    long sum = (long)hharray_reduce_batch(array, 0, add_batch, &calls);
+    printf("Sum: %ld in %zu calls", sum, calls);
+    assert(sum == (long)hharray_reduce(array, 0, add_long));
+    assert(calls == 5);
+    assert(hharray_size(doubled) == hharray_size(expected_doubled));
+    for (size_t i = 0; i < hharray_size(doubled); i++) {
+        assert(hharray_get(doubled, i) == hharray_get(expected_doubled, i));
+    }
+    assert(hharray_size(evens) == hharray_size(expected_evens));
+    for (size_t i = 0; i < hharray_size(evens); i++) {
+        assert(hharray_get(evens, i) == hharray_get(expected_evens, i));
+    }
+    hharray_destroy(expected_evens);
+    hharray_destroy(evens);
+    hharray_destroy(expected_doubled);
+    hharray_destroy(doubled);
+    hharray_destroy(array);
+
+    HHArray empty = hharray_create();
+    doubled = hharray_map_batch(empty, double_batch, &factor);
+    evens = hharray_filter_batch(empty, is_even_batch, NULL);
+    calls = 0;
+    assert(hharray_size(doubled) == 0 && hharray_size(evens) == 0);
+    assert(hharray_reduce_batch(empty, (void *)7, add_batch, &calls) == (void *)7 && calls == 0);
+    hharray_destroy(evens);
+    hharray_destroy(doubled);
+    hharray_destroy(empty);
+}
+
+void test_i64() {
+    printtest("Integer Aggregates");
+    HHArray array = hharray_create();
+    for (size_t i = 0; i < 1003; i++) {
+        hharray_append(array, (void *)(long)(rand() % 2001 - 1000));
+    }
+    long sum = 0, lowest = 1000, highest = -1000;
+    size_t in_range = 0;
+    size_t expected_buckets[4] = {0};
+    size_t expected_shifted[4] = {0};
+    for (size_t i = 0; i < hharray_size(array); i++) {
+        long value = (long)hharray_get(array, i);
+        sum += value;
+        if (value < lowest) lowest = value;
+        if (value > highest) highest = value;
+        in_range += (value >= -100 && value < 250);
+        if (value >= 0 && value < 1000) expected_buckets[value / 250]++;
+        if (value >= -512 && value < 512) expected_shifted[(value + 512) / 256]++;
+    }
+    printf("Sum: %ld, Min: %ld, Max: %ld", (long)hharray_i64_sum(array),
+           (long)hharray_i64_min(array), (long)hharray_i64_max(array));
+    assert(hharray_i64_sum(array) == sum);
+    assert(hharray_i64_min(array) == lowest);
+    assert(hharray_i64_max(array) == highest);
+    assert(hharray_i64_count_if_range(array, -100, 250) == in_range);
+
+    size_t buckets[4] = {0};
+    hharray_i64_histogram(array, 0, 250, buckets, 4);
+    for (size_t i = 0; i < 4; i++) {
+        assert(buckets[i] == expected_buckets[i]);
+    }
+    // A power-of-two width takes the shifting path.
+    size_t shifted[4] = {0};
+    hharray_i64_histogram(array, -512, 256, shifted, 4);
+    for (size_t i = 0; i < 4; i++) {
+        assert(shifted[i] == expected_shifted[i]);
+    }
+
+    HHArray prefix = hharray_copy(array);
+    hharray_i64_prefix_sum(prefix);
+    long running = 0;
+    for (size_t i = 0; i < hharray_size(array); i++) {
+        running += (long)hharray_get(array, i);
+        assert((long)hharray_get(prefix, i) == running);
+    }
+    hharray_destroy(prefix);
+    hharray_destroy(array);
+}
+
+void test_compressed() {
+    printtest("Compressed");
+    HHArray array = hharray_create();
+    long value = -5000;
+    for (size_t i = 0; i < 10007; i++) {
+        // Mostly small gaps, with duplicates and a few huge jumps.
+        value += i == 5000 ? 1L << 40 : (i % 1000 == 999) ? 1L << 20 : rand() % 200;
+        hharray_append(array, (void *)value);
+    }
+    HHCompressedArray compressed = hharray_freeze_compressed(array);
+    size_t size = hharray_size(array);
+    printf("%zu values in %zu bytes (uncompressed %zu)", size,
+           hharray_compressed_memory(compressed), size * sizeof(void *));
+    assert(hharray_compressed_size(compressed) == size);
+    assert(hharray_compressed_memory(compressed) * 4 < size * sizeof(void *));
+    for (size_t i = 0; i < size; i++) {
+        assert(hharray_compressed_get(compressed, i) == (long)hharray_get(array, i));
+    }
+
+    for (size_t trial = 0; trial < 1000; trial++) {
+        long probe = (long)hharray_get(array, rand() % size) + rand() % 3 - 1;
+        size_t expected = 0;
+        while (expected < size && (long)hharray_get(array, expected) < probe) expected++;
+        assert(hharray_compressed_lower_bound(compressed, probe) == expected);
+    }
+    assert(hharray_compressed_lower_bound(compressed, LONG_MIN) == 0);
+    assert(hharray_compressed_lower_bound(compressed, LONG_MAX) == size);
+
+    int64_t window[300];
+    size_t start = 70;
+    while (start < size) {
+        size_t decoded = hharray_compressed_decode(compressed, start, window, 300);
+        assert(decoded == (size - start < 300 ? size - start : 300));
+        for (size_t i = 0; i < decoded; i++) {
+            assert(window[i] == (long)hharray_get(array, start + i));
+        }
+        start += decoded;
+    }
+
+    HHArray thawed = hharray_compressed_thaw(compressed);
+    assert(hharray_size(thawed) == size);
+    for (size_t i = 0; i < size; i++) {
+        assert(hharray_get(thawed, i) == hharray_get(array, i));
+    }
+    hharray_destroy(thawed);
+    hharray_compressed_destroy(compressed);
+
+    HHArray empty = hharray_create();
+    compressed = hharray_freeze_compressed(empty);
+    assert(hharray_compressed_size(compressed) == 0);
+    assert(hharray_compressed_lower_bound(compressed, 0) == 0);
+    thawed = hharray_compressed_thaw(compressed);
+    assert(hharray_size(thawed) == 0);
+    hharray_destroy(thawed);
+    hharray_compressed_destroy(compressed);
+    hharray_destroy(empty);
+    hharray_destroy(array);
+}
+
+size_t hash_string(void *s) {
+    size_t hash = 5381;
+    for (char *c = s; *c; c++) {
+        hash = hash * 33 + (unsigned char)*c;
+    }
+    return hash;
+}
+
+int string_equal(void *a, void *b) {
+    return strcmp(a, b) == 0;
+}
+
+void test_unique() {
+    printtest("Unique");
+    HHArray array = hharray_create();
+    fill_array(array, 1000);
+    HHArray expected = hharray_create();
+    for (size_t i = 0; i < hharray_size(array); i++) {
+        if (hharray_find(expected, hharray_get(array, i)) == HHArrayNotFound) {
+            hharray_append(expected, hharray_get(array, i));
+        }
+    }
+    assert(hharray_distinct_count(array, NULL, NULL) == hharray_size(expected));
+    hharray_unique(array, NULL, NULL);
+    hharray_print_f(array, print);
+    assert(hharray_size(array) == hharray_size(expected));
+    for (size_t i = 0; i < hharray_size(array); i++) {
+        assert(hharray_get(array, i) == hharray_get(expected, i));
+    }
+    hharray_destroy(expected);
+    hharray_destroy(array);
+
+    char words[][6] = {"apple", "pear", "apple", "fig", "pear", "kiwi"};
+    HHArray strings = hharray_create();
+    for (size_t i = 0; i < 6; i++) {
+        hharray_append(strings, words[i]);
+    }
+    assert(hharray_distinct_count(strings, hash_string, string_equal) == 4);
+    hharray_unique(strings, hash_string, string_equal);
+    assert(hharray_size(strings) == 4);
+    assert(hharray_get(strings, 0) == words[0]);
+    assert(hharray_get(strings, 1) == words[1]);
+    assert(hharray_get(strings, 2) == words[3]);
+    assert(hharray_get(strings, 3) == words[5]);
+    hharray_destroy(strings);
+}
+
+typedef struct {
+    long deadline;
+    size_t position;
+} Timer;
+
+int cmp_timer(const void *a, const void *b) {
+    Timer *first = CASTREF(Timer *, a);
+    Timer *second = CASTREF(Timer *, b);
+    return (first->deadline > second->deadline) - (first->deadline < second->deadline);
+}
+
+void timer_moved(void *timer, size_t index) {
+    ((Timer *)timer)->position = index;
+}
+
+void test_heap() {
+    printtest("Heap");
+    HHArray array = hharray_create();
+    fill_array(array, 200);
+    hharray_heapify(array, cmpfunc, NULL);
+    for (int i = 0; i < 50; i++) {
+        hharray_heap_push(array, (void *)(long)(rand() % 100), cmpfunc, NULL);
+    }
+    hharray_heap_replace(array, (void *)50L, cmpfunc, NULL);
+    HHArray popped = hharray_create();
+    while (hharray_size(array) > 0) {
+        void *top = hharray_heap_peek(array);
+        assert(hharray_heap_pop(array, cmpfunc, NULL) == top);
+        hharray_append(popped, top);
+    }
+    hharray_print_f(popped, print);
+    assert(hharray_size(popped) == 250);
+    assert(hharray_is_sorted(popped, cmpfunc));
+    hharray_destroy(popped);
+    hharray_destroy(array);
+
+    Timer timers[100];
+    HHArray queue = hharray_create();
+    for (size_t i = 0; i < 100; i++) {
+        timers[i].deadline = rand() % 1000 + 1000;
+        hharray_heap_push(queue, &timers[i], cmp_timer, timer_moved);
+    }
+    for (size_t i = 0; i < 100; i++) {
+        assert(hharray_get(queue, timers[i].position) == &timers[i]);
+    }
+    timers[42].deadline = 1;
+    hharray_heap_decrease_key(queue, timers[42].position, &timers[42], cmp_timer, timer_moved);
+    assert(hharray_heap_pop(queue, cmp_timer, timer_moved) == &timers[42]);
+    long previous = 0;
+    while (hharray_size(queue) > 0) {
+        Timer *timer = hharray_heap_pop(queue, cmp_timer, timer_moved);
+        assert(timer->deadline >= previous);
+        previous = timer->deadline;
+    }
+    hharray_destroy(queue);
+}
+
+void test_segmented() {
+    printtest("Segmented");
+    HHSegmentedArray array = hharray_segmented_create();
+    for (long i = 0; i < 100; i++) {
+        hharray_segmented_append(array, (void *)i);
+    }
+    void **slot = hharray_segmented_slot(array, 42);
+    for (long i = 100; i < 100000; i++) {
+        hharray_segmented_append(array, (void *)i);
+    }
+    assert(hharray_segmented_slot(array, 42) == slot);
+    assert((long)*slot == 42);
+    for (size_t i = 0; i < hharray_segmented_size(array); i += 997) {
+        assert((long)hharray_segmented_get(array, i) == (long)i);
+    }
+    printf("%zu values in %zu segments", hharray_segmented_size(array),
+           hharray_segmented_segment_count(array));
+
+    HHSegmentedArray doubled = hharray_segmented_map(array, double_ptr);
+    HHSegmentedArray evens = hharray_segmented_filter(array, is_even);
+    long sum = (long)hharray_segmented_reduce(array, 0, add_long);
+    assert(sum == 99999L * 100000L / 2);
+    assert((long)hharray_segmented_get(doubled, 500) == 1000);
+    assert(hharray_segmented_size(evens) == 50000);
+    assert((long)hharray_segmented_remove_last(array) == 99999);
+
+    HHArray flat = hharray_segmented_to_array(array);
+    assert(hharray_size(flat) == 99999);
+    assert((long)hharray_get(flat, 12345) == 12345);
+
+    hharray_destroy(flat);
+    hharray_segmented_destroy(evens);
+    hharray_segmented_destroy(doubled);
+    hharray_segmented_destroy(array);
+}
+
+#define BUILDER_THREADS 4
+#define BUILDER_VALUES_PER_THREAD 100000
+
+typedef struct {
+    HHArrayBuilder builder;
+    long thread;
+} BuilderJob;
+
+void *build_values(void *arg) {
+    BuilderJob *job = arg;
+    HHArrayBuilderLocal local = hharray_builder_local(job->builder, job->thread);
+    for (long i = 0; i < BUILDER_VALUES_PER_THREAD; i++) {
+        hharray_builder_append(local, (void *)(job->thread * BUILDER_VALUES_PER_THREAD + i));
+    }
+    return NULL;
+}
+
+void test_builder() {
+    printtest("Parallel Builder");
+    HHArrayBuilder builder = hharray_builder_create(BUILDER_THREADS);
+    pthread_t threads[BUILDER_THREADS];
+    BuilderJob jobs[BUILDER_THREADS];
+    for (long t = 0; t < BUILDER_THREADS; t++) {
+        jobs[t] = (BuilderJob){builder, t};
+        pthread_create(&threads[t], NULL, build_values, &jobs[t]);
+    }
+    for (long t = 0; t < BUILDER_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    HHArray array = hharray_builder_finish(builder, BUILDER_THREADS);
+    printf("Built %zu values", hharray_size(array));
+    assert(hharray_size(array) == BUILDER_THREADS * BUILDER_VALUES_PER_THREAD);
+    for (size_t i = 0; i < hharray_size(array); i++) {
+        assert((long)hharray_get(array, i) == (long)i);
+    }
+    hharray_destroy(array);
+}
+
+#define CONCURRENT_READS 2000000
+#define CONCURRENT_MAX_READERS 8
+
+typedef struct {
+    HHConcurrentArray array;
+    long checksum;
+} ReaderJob;
+
+void *read_values(void *arg) {
+    ReaderJob *job = arg;
+    HHConcurrentReader reader = hharray_concurrent_reader_register(job->array);
+    long checksum = 0;
+    for (size_t i = 0; i < CONCURRENT_READS;) {
+        hharray_concurrent_read_begin(reader);
+        size_t size = hharray_concurrent_size(reader);
+        for (size_t j = 0; j < 64; j++, i++) {
+            long value = (long)hharray_concurrent_get(reader, (i * 7919) % size);
+            assert(value >= 0 && value < 1000000);
+            checksum += value;
+        }
+        hharray_concurrent_read_end(reader);
+    }
+    hharray_concurrent_reader_release(reader);
+    job->checksum = checksum;
+    return NULL;
+}
+
+typedef struct {
+    HHConcurrentArray array;
+    int done;
+} WriterJob;
+
+void *write_values(void *arg) {
+    WriterJob *job = arg;
+    for (long i = 1000; !__atomic_load_n(&job->done, __ATOMIC_RELAXED); i = (i + 1) % 1000000) {
+        if (i % 4 == 0) {
+            hharray_concurrent_insert_index(job->array, (void *)i, 0);
+            hharray_concurrent_remove_index(job->array, 0);
+        } else {
+            hharray_concurrent_append(job->array, (void *)i);
+        }
+    }
+    return NULL;
+}
+
+double monotonic_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / NSEC_PER_SEC;
+}
+
+void test_concurrent() {
+    printtest("Concurrent Readers");
+    for (size_t readers = 1; readers <= 4; readers *= 2) {
+        HHConcurrentArray array = hharray_concurrent_create(1000, CONCURRENT_MAX_READERS);
+        for (long i = 0; i < 1000; i++) {
+            hharray_concurrent_append(array, (void *)i);
+        }
+        WriterJob writer_job = {array, 0};
+        pthread_t writer;
+        pthread_create(&writer, NULL, write_values, &writer_job);
+        pthread_t threads[CONCURRENT_MAX_READERS];
+        ReaderJob jobs[CONCURRENT_MAX_READERS];
+        double start = monotonic_seconds();
+        for (size_t t = 0; t < readers; t++) {
+            jobs[t] = (ReaderJob){array, 0};
+            pthread_create(&threads[t], NULL, read_values, &jobs[t]);
+        }
+        for (size_t t = 0; t < readers; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        double elapsed = monotonic_seconds() - start;
+        __atomic_store_n(&writer_job.done, 1, __ATOMIC_RELAXED);
+        pthread_join(writer, NULL);
+        double throughput = readers * CONCURRENT_READS / elapsed;
+        printf("%zu reader(s): %.1f million reads/s\n", readers, throughput / 1e6);
+        HHArray copy = hharray_concurrent_copy(array);
+        assert(hharray_size(copy) >= 1000);
+        hharray_destroy(copy);
+        hharray_concurrent_destroy(array);
+    }
+}
+
 void test_pointer_print() {
     printtest("Pointer Print");
     HHArray array = hharray_create();
@@ -234,6 +916,28 @@ void test_append_list() {
     hharray_destroy(dst);
 }
 
+void test_append_list_growth() {
+    printtest("Append List Growth");
+    HHArray array = hharray_create();
+    HHArray single = hharray_create();
+    hharray_append(single, (void *)1);
+    size_t growths = 0;
+    size_t capacity = hharray_capacity(array);
+    for (size_t i = 0; i < 100000; i++) {
+        hharray_append_list(array, single);
+        if (hharray_capacity(array) != capacity) {
+            assert(hharray_capacity(array) >= hharray_policy_grown_capacity(capacity));
+            capacity = hharray_capacity(array);
+            growths++;
+        }
+    }
+    assert(hharray_size(array) == 100000);
+    // 10 * 1.5^k passes 100000 at k = 23.
+    assert(growths <= 24);
+    hharray_destroy(single);
+    hharray_destroy(array);
+}
+
 void test_insert_list() {
     printtest("Insert List");
     HHArray src = hharray_create();
@@ -255,6 +959,38 @@ void test_insert_list() {
     hharray_destroy(dst);
 }
 
+void test_splice() {
+    printtest("Splice");
+    HHArray dest = sorted_range(0, 10, 1);
+    HHArray source = sorted_range(100, 110, 1);
+    HHArray removed = NULL;
+    hharray_splice(dest, 2, 3, source, 4, 5, &removed);
+    fputs("Spliced: ", stdout);
+    hharray_print_f(dest, print);
+    fputs("\nRemoved: ", stdout);
+    hharray_print_f(removed, print);
+    putchar('\n');
+    long expected[] = {0, 1, 104, 105, 106, 107, 108, 5, 6, 7, 8, 9};
+    assert(hharray_size(dest) == 12);
+    for (size_t i = 0; i < 12; i++) {
+        assert((long)hharray_get(dest, i) == expected[i]);
+    }
+    assert(hharray_size(removed) == 3);
+    assert((long)hharray_get(removed, 0) == 2 && (long)hharray_get(removed, 2) == 4);
+
+    hharray_splice(dest, 0, 7, NULL, 0, 0, NULL);
+    assert(hharray_size(dest) == 5 && (long)hharray_get(dest, 0) == 5);
+    hharray_insert_list(dest, source, hharray_size(dest));
+    assert(hharray_size(dest) == 15 && (long)hharray_get(dest, 14) == 109);
+    hharray_splice(dest, 0, 0, dest, 10, 5, NULL);
+    assert(hharray_size(dest) == 20 && (long)hharray_get(dest, 0) == 105);
+    assert((long)hharray_get(dest, 5) == 5);
+
+    hharray_destroy(removed);
+    hharray_destroy(source);
+    hharray_destroy(dest);
+}
+
 void test_reverse() {
     printtest("Reverse");
     HHArray array = hharray_create();
@@ -269,6 +1005,80 @@ void test_reverse() {
     hharray_destroy(array);
 }
 
+void test_rotate() {
+    printtest("Rotate");
+    HHArray array = hharray_create();
+    for (long i = 0; i < 37; i++) {
+        hharray_append(array, (void *)i);
+    }
+    hharray_rotate(array, 10);
+    fputs("Rotated by 10: ", stdout);
+    hharray_print_f(array, print);
+    putchar('\n');
+    for (size_t i = 0; i < hharray_size(array); i++) {
+        assert((long)hharray_get(array, i) == (long)((i + 10) % 37));
+    }
+    hharray_rotate(array, 27);
+    hharray_reverse(array);
+    for (size_t i = 0; i < hharray_size(array); i++) {
+        assert((long)hharray_get(array, i) == (long)(36 - i));
+    }
+    hharray_destroy(array);
+}
+
+void test_permute() {
+    printtest("Permute and Gather");
+    HHArray array = hharray_create();
+    fill_array(array, 20);
+    size_t order[20];
+    for (size_t i = 0; i < 20; i++) {
+        order[i] = 19 - i;
+    }
+    HHArray gathered = hharray_gather(array, order, 20);
+    hharray_permute(array, order);
+    fputs("Permuted: ", stdout);
+    hharray_print_f(array, print);
+    putchar('\n');
+    for (size_t i = 0; i < 20; i++) {
+        assert(hharray_get(array, i) == hharray_get(gathered, i));
+    }
+    hharray_reverse(gathered);
+    hharray_permute(array, order);
+    for (size_t i = 0; i < 20; i++) {
+        assert(hharray_get(array, i) == hharray_get(gathered, i));
+    }
+    hharray_destroy(gathered);
+    hharray_destroy(array);
+
+    // Neither a rotation nor a random shuffle is its own inverse, so these
+    // tell gathering (new[i] = old[p[i]]) apart from scattering (new[p[i]] = old[i]).
+    const size_t size = 1000;
+    size_t *permutation = calloc(size, sizeof(size_t));
+    HHRandom rng;
+    hharray_random_seed(&rng, 28);
+    for (int trial = 0; trial < 2; trial++) {
+        for (size_t i = 0; i < size; i++) {
+            permutation[i] = trial == 0 ? (i + 7) % size : i;
+        }
+        for (size_t i = size - 1; trial == 1 && i > 0; i--) {
+            size_t j = hharray_random_bounded(&rng, i + 1);
+            size_t tmp = permutation[i];
+            permutation[i] = permutation[j];
+            permutation[j] = tmp;
+        }
+        array = sorted_range(0, (long)size, 1);
+        gathered = hharray_gather(array, permutation, size);
+        hharray_permute(array, permutation);
+        for (size_t i = 0; i < size; i++) {
+            assert((size_t)hharray_get(array, i) == permutation[i]);
+            assert(hharray_get(array, i) == hharray_get(gathered, i));
+        }
+        hharray_destroy(gathered);
+        hharray_destroy(array);
+    }
+    free(permutation);
+}
+
 void test_slice() {
     printtest("Slice");
     HHArray array = hharray_create();
@@ -280,10 +1090,49 @@ void test_slice() {
     fputs("Sliced: ", stdout);
     hharray_print_f(sliced, print);
     putchar('\n');
+    HHArray whole = hharray_slice(array, 0, hharray_size(array));
+    assert(hharray_size(whole) == hharray_size(array));
+    hharray_destroy(whole);
     hharray_destroy(array);
     hharray_destroy(sliced);
 }
 
+void test_try() {
+    printtest("Status Codes");
+    HHArray array = hharray_create();
+    fill_array(array, 5);
+    void *value = NULL;
+    assert(hharray_try_get(array, 4, &value) == HHArrayStatusOK);
+    assert(value == hharray_get(array, 4));
+    assert(hharray_try_get(array, 5, &value) == HHArrayStatusIndexOutOfBounds);
+    assert(hharray_try_swap(array, 0, 5) == HHArrayStatusIndexOutOfBounds);
+    assert(hharray_try_insert_index(array, (void *)7, 5) == HHArrayStatusOK);
+    assert(hharray_try_insert_index(array, (void *)7, 7) == HHArrayStatusIndexOutOfBounds);
+    assert(hharray_try_remove_index(array, 5, &value) == HHArrayStatusOK);
+    assert((long)value == 7);
+    assert(hharray_try_remove_index(array, 5, NULL) == HHArrayStatusIndexOutOfBounds);
+    while (hharray_try_pop(array, NULL) == HHArrayStatusOK);
+    assert(hharray_size(array) == 0);
+    assert(hharray_try_pop(array, &value) == HHArrayStatusEmpty);
+#ifndef HHARRAY_CHECKED
+    // Misuse is fatal in checked builds; otherwise the call reports it and
+    // returns without touching the array.
+    hharray_append(array, (void *)1);
+    assert(hharray_remove(array, (void *)2) == NULL);
+    assert(hharray_size(array) == 1 && (long)hharray_get(array, 0) == 1);
+    putchar('\n');
+#endif
+    HHArray empty = hharray_create();
+    HHArray mapped = hharray_map(empty, double_ptr);
+    HHArray filtered = hharray_filter(empty, is_even);
+    assert(hharray_size(mapped) == 0 && hharray_size(filtered) == 0);
+    hharray_destroy(filtered);
+    hharray_destroy(mapped);
+    hharray_destroy(empty);
+    fputs("All status codes as expected.", stdout);
+    hharray_destroy(array);
+}
+
 void test_stress() {
     printtest("Stress");
     HHArray array = hharray_create();
@@ -303,6 +1152,288 @@ void print_char(void *c) {
     printf("%c", (char)c);
 }
 
+typedef struct {
+    int x;
+    int y;
+} Point;
+
+#define point_less(a, b) ((a)->x < (b)->x || ((a)->x == (b)->x && (a)->y < (b)->y))
+
+HHARRAY_DECLARE(point_array, Point)
+HHARRAY_DEFINE(point_array, Point)
+HHARRAY_DEFINE_SORT(point_array, point_less)
+
+int cmp_point(const void *a, const void *b) {
+    const Point *p = a, *q = b;
+    return point_less(p, q) ? -1 : point_less(q, p) ? 1 : 0;
+}
+
+Point mirror_point(const Point *p) {
+    return (Point){p->y, p->x};
+}
+
+int is_diagonal(const Point *p) {
+    return p->x == p->y;
+}
+
+Point add_point(Point sum, const Point *p) {
+    return (Point){sum.x + p->x, sum.y + p->y};
+}
+
+void test_typed() {
+    printtest("Typed");
+    point_array points = point_array_create();
+    for (int i = 0; i < 5000; i++) {
+        point_array_append(points, (Point){rand() % 100, rand() % 100});
+    }
+    assert(point_array_size(points) == 5000);
+    point_array sorted = point_array_copy(points);
+    point_array_sort(sorted);
+    qsort(point_array_values(points), point_array_size(points), sizeof(Point), cmp_point);
+    assert(memcmp(point_array_values(sorted), point_array_values(points), 5000 * sizeof(Point)) == 0);
+    Point first = point_array_get(sorted, 0), last = point_array_get(sorted, 4999);
+    printf("Sorted %zu points from (%d, %d) to (%d, %d)", point_array_size(sorted),
+           first.x, first.y, last.x, last.y);
+    point_array_destroy(sorted);
+
+    point_array_insert_index(points, (Point){-1, -1}, 0);
+    point_array_insert_index(points, (Point){-2, -2}, point_array_size(points));
+    assert(point_array_get(points, 0).x == -1 && point_array_get(points, 5001).x == -2);
+    assert(point_array_remove_index(points, 0).x == -1);
+    assert(point_array_remove_last(points).x == -2);
+    point_array_slot(points, 0)->x = 1000;
+    point_array_set(points, 1, (Point){7, 7});
+
+    point_array slice = point_array_slice(points, 10, 0);
+    assert(point_array_size(slice) == 10 && point_array_get(slice, 9).x == 1000);
+    point_array_insert_list(slice, slice, 5);
+    assert(point_array_size(slice) == 20 && point_array_get(slice, 14).x == 1000);
+    assert(point_array_get(slice, 15).x == point_array_get(slice, 5).x);
+
+    point_array mirrored = point_array_map(points, mirror_point);
+    point_array diagonal = point_array_filter(points, is_diagonal);
+    Point sum = point_array_reduce(points, (Point){0, 0}, add_point);
+    Point mirrored_sum = point_array_reduce(mirrored, (Point){0, 0}, add_point);
+    assert(sum.x == mirrored_sum.y && sum.y == mirrored_sum.x);
+    size_t expected_diagonal = 0;
+    for (size_t i = 0; i < point_array_size(points); i++) {
+        expected_diagonal += is_diagonal(point_array_slot(points, i));
+    }
+    assert(point_array_size(diagonal) == expected_diagonal);
+
+    point_array_destroy(diagonal);
+    point_array_destroy(mirrored);
+    point_array_destroy(slice);
+    point_array_destroy(points);
+}
+
+/**
+ * Consumes every value a parent process appends, checking they arrive in
+ * order, and exits with the status of the check.
+ */
+void consume_values(const char *name, uint64_t count) {
+    HHSharedArray shared = hharray_attach_shared(name);
+    uint64_t value, expected = 0;
+    while (hharray_shared_consume(shared, &value) == HHArrayStatusOK) {
+        if (value != expected * 3) exit(EXIT_FAILURE);
+        expected++;
+    }
+    int ok = expected == count && hharray_shared_size(shared) == count &&
+             hharray_shared_get(shared, count - 1) == (count - 1) * 3;
+    hharray_shared_detach(shared);
+    exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+void test_shared() {
+    printtest("Shared");
+    char name[64];
+    snprintf(name, sizeof(name), "/hharray_test_%d", (int)getpid());
+    const uint64_t count = 200000;
+    HHSharedArray shared = hharray_create_shared(name, 16);
+    // Flush so the child doesn't inherit, and print again, buffered output.
+    fflush(stdout);
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) consume_values(name, count);
+
+    uint64_t batch[100];
+    for (uint64_t i = 0; i < count;) {
+        if (i % 1000 == 0) {
+            for (size_t j = 0; j < 100; j++) {
+                batch[j] = (i + j) * 3;
+            }
+            hharray_shared_append_values(shared, batch, 100);
+            i += 100;
+        } else {
+            hharray_shared_append(shared, i++ * 3);
+        }
+    }
+    hharray_shared_close(shared);
+    int status;
+    waitpid(child, &status, 0);
+    printf("Child consumed %llu values: %s", (unsigned long long)count,
+           WIFEXITED(status) && WEXITSTATUS(status) == 0 ? "ok" : "failed");
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS);
+
+    HHSharedArray attached = hharray_attach_shared(name);
+    hharray_shared_set(attached, 5, 42);
+    assert(hharray_shared_get(shared, 5) == 42);
+    assert(hharray_shared_values(shared)[6] == 18);
+    uint64_t value;
+    assert(hharray_shared_try_consume(attached, &value) == HHArrayStatusEmpty);
+    HHArray copy = hharray_shared_to_array(attached);
+    assert(hharray_size(copy) == count && (long)hharray_get(copy, count - 1) == (long)(count - 1) * 3);
+    hharray_destroy(copy);
+    hharray_shared_detach(attached);
+    hharray_shared_detach(shared);
+    hharray_shared_unlink(name);
+}
+
+/**
+ * The `i`th of `size` sorted values in one of three layouts: distinct
+ * values, runs of seven equal values, or one run covering the middle half,
+ * which includes the tree's root.
+ */
+long search_value(size_t i, size_t size, int layout) {
+    if (layout == 0) return (long)(2 * i - i % 3);
+    if (layout == 1) return (long)(i / 7 * 2);
+    size_t run_start = size / 4, run_end = size - size / 4;
+    return (long)(i < run_start || i >= run_end ? 2 * i : 2 * run_start);
+}
+
+void test_search_index() {
+    printtest("Search Index");
+    for (size_t size = 0; size < 300; size++) {
+        for (int layout = 0; layout < 3; layout++) {
+            HHArray array = hharray_create();
+            for (size_t i = 0; i < size; i++) {
+                hharray_append(array, (void *)search_value(i, size, layout));
+            }
+            HHSearchIndex index = hharray_build_search_index(array, cmpfunc);
+            HHSearchIndex index_i64 = hharray_build_search_index_i64(array);
+            assert(hharray_index_size(index) == size);
+            for (long value = -2; value < (long)(2 * size + 2); value++) {
+                // The first of a run of equal values, not just any of them.
+                size_t expected = 0;
+                while (expected < size && (long)hharray_get(array, expected) < value) expected++;
+                assert(hharray_index_lower_bound(index, (void *)value) == expected);
+                assert(hharray_index_lower_bound_i64(index_i64, value) == expected);
+                int present = expected < size && (long)hharray_get(array, expected) == value;
+                size_t found = present ? expected : HHArrayNotFound;
+                assert(hharray_index_find(index, (void *)value) == found);
+                assert(hharray_index_find(index_i64, (void *)value) == found);
+            }
+            hharray_index_destroy(index_i64);
+            hharray_index_destroy(index);
+            hharray_destroy(array);
+        }
+    }
+
+    const size_t size = 1 << 22, queries = 1 << 20;
+    HHArray array = sorted_range(0, 3 * size, 3);
+    HHSearchIndex index = hharray_build_search_index(array, cmpfunc);
+    HHSearchIndex index_i64 = hharray_build_search_index_i64(array);
+    long *probes = calloc(queries, sizeof(long));
+    for (size_t i = 0; i < queries; i++) {
+        probes[i] = ((long)rand() * RAND_MAX + rand()) % (3 * size);
+    }
+    size_t checksum = 0;
+    double start = monotonic_seconds();
+    for (size_t i = 0; i < queries; i++) {
+        checksum += hharray_index_lower_bound(index, (void *)probes[i]);
+    }
+    double eytzinger = monotonic_seconds() - start;
+    start = monotonic_seconds();
+    for (size_t i = 0; i < queries; i++) {
+        checksum += hharray_index_lower_bound_i64(index_i64, probes[i]);
+    }
+    double eytzinger_i64 = monotonic_seconds() - start;
+    void **values = hharray_values(array);
+    start = monotonic_seconds();
+    for (size_t i = 0; i < queries; i++) {
+        void **found = bsearch(&probes[i], values, size, sizeof(void *), cmpfunc);
+        checksum -= 2 * (found ? (size_t)(found - values) : (size_t)probes[i] / 3 + 1);
+    }
+    double binary = monotonic_seconds() - start;
+    free(values);
+    printf("%zu lookups in %zu values: index %.1fns, integer index %.1fns, bsearch %.1fns",
+           queries, size, eytzinger * NSEC_PER_SEC / queries,
+           eytzinger_i64 * NSEC_PER_SEC / queries, binary * NSEC_PER_SEC / queries);
+    assert(checksum == 0);
+    free(probes);
+    hharray_index_destroy(index_i64);
+    hharray_index_destroy(index);
+    hharray_destroy(array);
+}
+
+void fill_row(size_t row, void **values, size_t count, void *context) {
+    (void)context;
+    for (size_t i = 0; i < count; i++) {
+        values[i] = (void *)(row * 1000 + i);
+    }
+}
+
+void sum_row(size_t row, void **values, size_t count, void *context) {
+    (void)row;
+    for (size_t i = 0; i < count; i++) {
+        *(long *)context += (long)values[i];
+    }
+}
+
+void test_jagged() {
+    printtest("Jagged");
+    const size_t row_count = 100000;
+    size_t *counts = calloc(row_count, sizeof(size_t));
+    long expected_sum = 0;
+    for (size_t row = 0; row < row_count; row++) {
+        counts[row] = rand() % 8;
+        for (size_t i = 0; i < counts[row]; i++) {
+            expected_sum += (long)(row * 1000 + i);
+        }
+    }
+    HHJaggedArray jagged = hharray_jagged_build(counts, row_count, fill_row, NULL, 4);
+    assert(hharray_jagged_row_count(jagged) == row_count);
+    for (size_t row = 0; row < row_count; row++) {
+        size_t count;
+        void **values = hharray_jagged_row(jagged, row, &count);
+        assert(count == counts[row] && hharray_jagged_row_size(jagged, row) == count);
+        for (size_t i = 0; i < count; i++) {
+            assert((size_t)values[i] == row * 1000 + i);
+        }
+    }
+    long sum = 0;
+    hharray_jagged_for_each(jagged, sum_row, &sum);
+    printf("%zu rows, %zu values, sum %ld", hharray_jagged_row_count(jagged),
+           hharray_jagged_size(jagged), sum);
+    assert(sum == expected_sum);
+
+    void *row[] = {(void *)1L, (void *)2L, (void *)3L};
+    hharray_jagged_append_row(jagged, row, 3);
+    hharray_jagged_append_row(jagged, NULL, 0);
+    for (long i = 0; i < 100; i++) {
+        hharray_jagged_append(jagged, (void *)i);
+    }
+    assert(hharray_jagged_row_count(jagged) == row_count + 2);
+    assert((long)hharray_jagged_get(jagged, row_count, 2) == 3);
+    assert((long)hharray_jagged_get(jagged, row_count + 1, 99) == 99);
+
+    HHArray nested = hharray_jagged_to_nested(jagged);
+    HHJaggedArray round_trip = hharray_jagged_from_nested(nested);
+    assert(hharray_jagged_size(round_trip) == hharray_jagged_size(jagged));
+    for (size_t r = 0; r < hharray_size(nested); r++) {
+        HHArray inner = hharray_get(nested, r);
+        assert(hharray_size(inner) == hharray_jagged_row_size(round_trip, r));
+        for (size_t i = 0; i < hharray_size(inner); i++) {
+            assert(hharray_get(inner, i) == hharray_jagged_get(round_trip, r, i));
+        }
+        hharray_destroy(inner);
+    }
+    hharray_destroy(nested);
+    hharray_jagged_destroy(round_trip);
+    hharray_jagged_destroy(jagged);
+    free(counts);
+}
+
 void test_string() {
     printtest("String");
     HHArray string = hharray_create();
@@ -322,19 +1453,43 @@ int main() {
     time_test(test_append);
     time_test(test_pointer_print);
     time_test(test_sort);
+    time_test(test_sort_stable);
+    time_test(test_selection);
+    time_test(test_merge);
+    time_test(test_set_operations);
     time_test(test_shuffle);
+    time_test(test_shuffle_r);
+    time_test(test_shuffle_parallel);
+    time_test(test_sample);
     time_test(test_map);
     time_test(test_filter);
     time_test(test_reduce);
+    time_test(test_batch);
+    time_test(test_i64);
+    time_test(test_compressed);
+    time_test(test_unique);
+    time_test(test_heap);
+    time_test(test_segmented);
+    time_test(test_builder);
+    time_test(test_concurrent);
+    time_test(test_shared);
     time_test(test_insert);
     time_test(test_insert_list);
     time_test(test_remove);
     time_test(test_remove_index);
     time_test(test_copy);
     time_test(test_reverse);
+    time_test(test_rotate);
+    time_test(test_permute);
     time_test(test_slice);
     time_test(test_append_list);
+    time_test(test_append_list_growth);
+    time_test(test_splice);
     time_test(test_string);
+    time_test(test_search_index);
+    time_test(test_jagged);
+    time_test(test_typed);
+    time_test(test_try);
     time_test(test_stress);
     putchar('\n');
 